@@ -0,0 +1,7 @@
+#pragma once
+
+// Global operator new replaced with a counting version when built with
+// -DMINESWEEPER_COUNT_ALLOCS; used to check that frames do not allocate
+#ifdef MINESWEEPER_COUNT_ALLOCS
+unsigned long allocationCount();
+#endif
@@ -0,0 +1,253 @@
+#include "board.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+void Board::reset(unsigned int rows, unsigned int cols, unsigned int mines, float cellSize, float top) {
+    this->rows = rows;
+    this->cols = cols;
+    totalMines = mines;
+    flagsUsed = 0;
+    firstClick = true;
+    metrics = BoardMetrics();
+    grid.clear();
+    grid.reserve(rows);
+    for (unsigned int i = 0; i < rows; ++i) {
+        std::vector<Cell> rowCells;
+        rowCells.reserve(cols);
+        for (unsigned int j = 0; j < cols; ++j) {
+            rowCells.emplace_back(j * cellSize, i * cellSize + top, cellSize);
+        }
+        grid.push_back(std::move(rowCells));
+    }
+    revealQueue.assign(rows * cols, 0);
+    queueHead = queueSize = 0;
+    queued.assign(rows * cols, 0);
+    revealedSafe = 0;
+    revealedMines = 0;
+}
+
+void Board::setChangeCallback(ChangeCallback callback) {
+    onChange = std::move(callback);
+}
+
+void Board::setAnimated(bool animated) {
+    this->animated = animated;
+}
+
+void Board::click(unsigned int row, unsigned int col) {
+    if (firstClick) {
+        // First click: place mines and compute adjacents
+        placeMines(row, col);
+        calculateAdjacents();
+        metrics = computeBoardMetrics(grid);
+        firstClick = false;
+        // clear any flags placed before game start
+        flagsUsed = 0;
+        for (unsigned int i = 0; i < rows; ++i) {
+            for (unsigned int j = 0; j < cols; ++j) {
+                if (grid[i][j].getState() == CellState::Flagged) {
+                    setCellState(i, j, CellState::Hidden);
+                }
+            }
+        }
+        revealCell(row, col);
+        return;
+    }
+    const Cell& cell = grid[row][col];
+    if (cell.getState() == CellState::Revealed && !cell.isMine() && cell.getAdjacentMines() > 0)
+        chord(row, col);
+    else
+        revealCell(row, col);
+}
+
+void Board::chord(unsigned int row, unsigned int col) {
+    const Cell& cell = grid[row][col];
+    if (cell.getState() != CellState::Revealed || cell.isMine() || cell.getAdjacentMines() <= 0) return;
+    // Chord reveal neighbors when flags match
+    int flagCount = 0;
+    for (int di = -1; di <= 1; ++di) {
+        for (int dj = -1; dj <= 1; ++dj) {
+            if (di == 0 && dj == 0) continue;
+            int ni = static_cast<int>(row) + di;
+            int nj = static_cast<int>(col) + dj;
+            if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols) &&
+                grid[ni][nj].getState() == CellState::Flagged) {
+                flagCount++;
+            }
+        }
+    }
+    if (flagCount != cell.getAdjacentMines()) return;
+    for (int di = -1; di <= 1; ++di) {
+        for (int dj = -1; dj <= 1; ++dj) {
+            if (di == 0 && dj == 0) continue;
+            int ni = static_cast<int>(row) + di;
+            int nj = static_cast<int>(col) + dj;
+            if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols) &&
+                grid[ni][nj].getState() == CellState::Hidden) {
+                enqueue(ni * cols + nj);
+            }
+        }
+    }
+    if (!animated)
+        processReveals(false);
+}
+
+void Board::toggleFlag(unsigned int row, unsigned int col) {
+    CellState state = grid[row][col].getState();
+    if (state == CellState::Hidden) {
+        setCellState(row, col, CellState::Flagged);
+        flagsUsed++;
+    } else if (state == CellState::Flagged) {
+        setCellState(row, col, CellState::Hidden);
+        flagsUsed--;
+    }
+}
+
+void Board::processReveals(bool budgeted, sf::Time budget) {
+    std::size_t wave = queueSize;
+    std::size_t done = 0;
+    sf::Clock budgetClock;
+    while (queueSize > 0) {
+        if (budgeted && (done == wave || ((done & 63) == 63 && budgetClock.getElapsedTime() >= budget)))
+            break;
+        unsigned int idx = revealQueue[queueHead];
+        queueHead = (queueHead + 1) % revealQueue.size();
+        queueSize--;
+        queued[idx] = 0;
+        ++done;
+        revealQueued(idx / cols, idx % cols);
+    }
+}
+
+bool Board::hasPendingReveals() const {
+    return queueSize > 0;
+}
+
+void Board::revealMines() {
+    for (unsigned int i = 0; i < rows; ++i)
+        for (unsigned int j = 0; j < cols; ++j)
+            if (grid[i][j].isMine() && grid[i][j].getState() == CellState::Hidden)
+                setCellState(i, j, CellState::Revealed);
+}
+
+// Every cell state change goes through here so counters and listeners stay in sync
+void Board::setCellState(unsigned int row, unsigned int col, CellState state) {
+    Cell& cell = grid[row][col];
+    if (cell.getState() == state) return;
+    unsigned int& revealed = cell.isMine() ? revealedMines : revealedSafe;
+    if (cell.getState() == CellState::Revealed) revealed--;
+    if (state == CellState::Revealed) revealed++;
+    if (onChange) onChange(row, col, cell.getState(), state);
+    cell.setState(state);
+}
+
+unsigned int Board::getRows() const { return rows; }
+unsigned int Board::getCols() const { return cols; }
+unsigned int Board::getMineCount() const { return totalMines; }
+unsigned int Board::getFlagsUsed() const { return flagsUsed; }
+void Board::setFlagsUsed(unsigned int flags) { flagsUsed = flags; }
+bool Board::isFirstClick() const { return firstClick; }
+bool Board::hitMine() const { return revealedMines > 0; }
+
+bool Board::isCleared() const {
+    return queueSize == 0 && revealedSafe == rows * cols - totalMines;
+}
+
+const BoardMetrics& Board::getMetrics() const { return metrics; }
+Cell& Board::cell(unsigned int row, unsigned int col) { return grid[row][col]; }
+const Cell& Board::cell(unsigned int row, unsigned int col) const { return grid[row][col]; }
+const std::vector<std::vector<Cell>>& Board::getGrid() const { return grid; }
+
+// Place mines randomly, excluding the first-clicked safe cell and its neighbors
+void Board::placeMines(unsigned int safeRow, unsigned int safeCol) {
+    // never ask for more mines than there are free cells, or the loop below cannot finish
+    unsigned int safeRows = std::min(safeRow + 1, rows - 1) - (safeRow > 0 ? safeRow - 1 : 0) + 1;
+    unsigned int safeCols = std::min(safeCol + 1, cols - 1) - (safeCol > 0 ? safeCol - 1 : 0) + 1;
+    unsigned int freeCells = rows * cols - safeRows * safeCols;
+    if (totalMines > freeCells) {
+        std::cerr << "Too many mines for the board, placing " << freeCells << std::endl;
+        totalMines = freeCells;
+    }
+    unsigned int placed = 0;
+    while (placed < totalMines) {
+        unsigned int r = std::rand() % rows;
+        unsigned int c = std::rand() % cols;
+        // skip the safe cell, its neighbors, and already mined cells
+        if (grid[r][c].isMine() ||
+            (std::abs(static_cast<int>(r) - static_cast<int>(safeRow)) <= 1 &&
+             std::abs(static_cast<int>(c) - static_cast<int>(safeCol)) <= 1)) {
+            continue;
+        }
+        grid[r][c].setMine(true);
+        placed++;
+    }
+}
+
+void Board::calculateAdjacents() {
+    for (unsigned int i = 0; i < rows; ++i) {
+        for (unsigned int j = 0; j < cols; ++j) {
+            if (grid[i][j].isMine()) {
+                grid[i][j].setAdjacentMines(-1);
+                continue;
+            }
+            int count = 0;
+            for (int di = -1; di <= 1; ++di) {
+                for (int dj = -1; dj <= 1; ++dj) {
+                    if (di == 0 && dj == 0) continue;
+                    int ni = static_cast<int>(i) + di;
+                    int nj = static_cast<int>(j) + dj;
+                    if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols)) {
+                        if (grid[ni][nj].isMine()) count++;
+                    }
+                }
+            }
+            grid[i][j].setAdjacentMines(count);
+        }
+    }
+}
+
+// Queue a cell for reveal; instant mode resolves the whole cascade right away
+void Board::revealCell(unsigned int row, unsigned int col) {
+    enqueue(row * cols + col);
+    if (!animated)
+        processReveals(false);
+}
+
+void Board::enqueue(unsigned int idx) {
+    if (queued[idx]) return;
+    queued[idx] = 1;
+    revealQueue[(queueHead + queueSize) % revealQueue.size()] = idx;
+    queueSize++;
+}
+
+void Board::revealQueued(unsigned int row, unsigned int col) {
+    Cell& cell = grid[row][col];
+    if (cell.getState() != CellState::Hidden) return;
+    setCellState(row, col, CellState::Revealed);
+    // If it's a mine, the game is lost: show the other mines too
+    if (cell.isMine()) {
+        revealMines();
+        return;
+    }
+    // Only auto-reveal neighbors if this cell has no adjacent mines
+    if (cell.getAdjacentMines() == 0) {
+        revealNeighbors(row, col);
+    }
+}
+
+void Board::revealNeighbors(unsigned int row, unsigned int col) {
+    for (int di = -1; di <= 1; ++di) {
+        for (int dj = -1; dj <= 1; ++dj) {
+            if (di == 0 && dj == 0) continue;
+            int ni = static_cast<int>(row) + di;
+            int nj = static_cast<int>(col) + dj;
+            if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols)) {
+                if (grid[ni][nj].getState() == CellState::Hidden && !grid[ni][nj].isMine()) {
+                    enqueue(ni * cols + nj);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <functional>
+#include <vector>
+#include "cell.hpp"
+#include "metrics.hpp"
+
+// The game rules without a window: mine placement on the first click, reveal
+// cascades, chords and flags. Shared by the SFML game and the headless bot mode.
+class Board {
+public:
+    // called for every cell state change, before the cell takes the new state
+    using ChangeCallback = std::function<void(unsigned int row, unsigned int col, CellState from, CellState to)>;
+
+    // start an empty board; mines are placed on the first click.
+    // Cells are laid out cellSize apart, starting top pixels down.
+    void reset(unsigned int rows, unsigned int cols, unsigned int mines, float cellSize = 1.f, float top = 0.f);
+    void setChangeCallback(ChangeCallback callback);
+    void setAnimated(bool animated); // leave cascades queued for processReveals
+
+    // player actions
+    void click(unsigned int row, unsigned int col); // reveal, or chord on a revealed number
+    void chord(unsigned int row, unsigned int col); // reveal around a number whose flags are all placed
+    void toggleFlag(unsigned int row, unsigned int col);
+
+    // Drain the reveal queue. When budgeted, reveal at most the cells that were
+    // queued when the call began (one ring of the cascade) and stop early once
+    // the budget is spent.
+    void processReveals(bool budgeted, sf::Time budget = sf::Time::Zero);
+    bool hasPendingReveals() const;
+    void revealMines(); // show every hidden mine
+    // direct state change, used by undo/redo
+    void setCellState(unsigned int row, unsigned int col, CellState state);
+
+    unsigned int getRows() const;
+    unsigned int getCols() const;
+    unsigned int getMineCount() const;
+    unsigned int getFlagsUsed() const;
+    void setFlagsUsed(unsigned int flags);
+    bool isFirstClick() const;
+    bool hitMine() const;   // a mine is showing
+    bool isCleared() const; // every safe cell revealed and no cascade pending
+    const BoardMetrics& getMetrics() const; // valid once mines are placed
+    Cell& cell(unsigned int row, unsigned int col);
+    const Cell& cell(unsigned int row, unsigned int col) const;
+    const std::vector<std::vector<Cell>>& getGrid() const;
+
+private:
+    void placeMines(unsigned int safeRow, unsigned int safeCol); //Place mines on first click, excluding the first clicked cell
+    void calculateAdjacents();
+    void revealCell(unsigned int row, unsigned int col);
+    void enqueue(unsigned int idx); // queue a cell for reveal unless it is already waiting
+    void revealNeighbors(unsigned int row, unsigned int col);
+    void revealQueued(unsigned int row, unsigned int col);
+
+    std::vector<std::vector<Cell>> grid;
+    unsigned int rows = 0;
+    unsigned int cols = 0;
+    unsigned int totalMines = 0;
+    unsigned int flagsUsed = 0;
+    bool firstClick = true;
+    bool animated = false;
+    BoardMetrics metrics;
+    // ring buffer of row * cols + col in cascade order; a cell is queued at most
+    // once at a time, so rows * cols slots allocated by reset() always suffice
+    std::vector<unsigned int> revealQueue;
+    std::size_t queueHead = 0;
+    std::size_t queueSize = 0;
+    std::vector<unsigned char> queued; // per cell: currently in revealQueue
+    unsigned int revealedSafe = 0;  // revealed non-mine cells, for win detection
+    unsigned int revealedMines = 0;
+    ChangeCallback onChange;
+};
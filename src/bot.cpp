@@ -0,0 +1,154 @@
+#include "bot.hpp"
+#include "board.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned int MaxSide = 1000; // cells are full SFML shapes, keep boards bounded
+
+struct Action {
+    char kind; // R, F or C
+    unsigned int row, col;
+};
+
+void skipSpaces(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+}
+
+bool readNumber(const char*& p, const char* end, unsigned int& value) {
+    skipSpaces(p, end);
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+void appendNumber(std::string& out, unsigned int value) {
+    char digits[16];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.push_back(' ');
+    out.append(digits, result.ptr);
+}
+
+// protocol value of a cell
+unsigned int cellValue(const Cell& cell) {
+    switch (cell.getState()) {
+    case CellState::Flagged: return 9;
+    case CellState::Hidden: return 10;
+    default: return cell.isMine() ? 11 : static_cast<unsigned int>(cell.getAdjacentMines());
+    }
+}
+
+char boardStatus(const Board& board) {
+    if (board.hitMine()) return 'L';
+    if (board.isCleared()) return 'W';
+    return 'P';
+}
+
+} // namespace
+
+int runBot(std::istream& in, std::ostream& out) {
+    Board board;
+    bool started = false;
+    // cells touched by the current request, each listed once with the value
+    // it had before, so cells that end up where they started can be skipped
+    std::vector<unsigned int> changed;
+    std::vector<unsigned char> marked;
+    std::vector<unsigned char> before;
+    board.setChangeCallback([&](unsigned int row, unsigned int col, CellState, CellState) {
+        unsigned int idx = row * board.getCols() + col;
+        if (!marked[idx]) {
+            marked[idx] = 1;
+            before[idx] = static_cast<unsigned char>(cellValue(board.cell(row, col)));
+            changed.push_back(idx);
+        }
+    });
+    std::vector<Action> actions;
+    std::string line, reply;
+    while (std::getline(in, line)) {
+        const char* p = line.data();
+        const char* end = p + line.size();
+        skipSpaces(p, end);
+        reply.clear();
+        if (p < end && *p == 'Q') break;
+        if (p < end && *p == 'N') {
+            ++p;
+            unsigned int seed, rows, cols, mines;
+            if (!readNumber(p, end, seed) || !readNumber(p, end, rows) || !readNumber(p, end, cols) || !readNumber(p, end, mines)) {
+                reply = "E expected N seed rows cols mines";
+            } else if (rows == 0 || cols == 0 || rows > MaxSide || cols > MaxSide) {
+                reply = "E board size out of range";
+            } else if (mines > 0 && (rows * cols < 9 || mines > rows * cols - 9)) {
+                // the first click and its neighbors are always safe
+                reply = "E too many mines";
+            } else {
+                std::srand(seed);
+                board.reset(rows, cols, mines);
+                marked.assign(rows * cols, 0);
+                before.assign(rows * cols, 0);
+                started = true;
+                reply = "P 0";
+            }
+        } else {
+            // parse the whole batch first so a bad line changes nothing
+            actions.clear();
+            const char* error = nullptr;
+            while (!error) {
+                skipSpaces(p, end);
+                if (p == end) break;
+                Action action;
+                action.kind = *p++;
+                if (action.kind != 'R' && action.kind != 'F' && action.kind != 'C')
+                    error = "E unknown command";
+                else if (!readNumber(p, end, action.row) || !readNumber(p, end, action.col))
+                    error = "E expected row and column";
+                else if (!started)
+                    error = "E no game, send N first";
+                else if (action.row >= board.getRows() || action.col >= board.getCols())
+                    error = "E cell out of range";
+                else
+                    actions.push_back(action);
+            }
+            if (error) {
+                reply = error;
+            } else {
+                for (const Action& action : actions) {
+                    // moves after the game ended are ignored
+                    if (board.hitMine() || board.isCleared()) break;
+                    if (action.kind == 'R') board.click(action.row, action.col);
+                    else if (action.kind == 'F') board.toggleFlag(action.row, action.col);
+                    else board.chord(action.row, action.col);
+                }
+                // drop cells that are back where they started, keeping the order
+                unsigned int cols = board.getCols();
+                std::size_t kept = 0;
+                for (unsigned int idx : changed) {
+                    marked[idx] = 0;
+                    if (cellValue(board.cell(idx / cols, idx % cols)) != before[idx])
+                        changed[kept++] = idx;
+                }
+                changed.resize(kept);
+                reply.push_back(boardStatus(board));
+                appendNumber(reply, static_cast<unsigned int>(changed.size()));
+                for (unsigned int idx : changed) {
+                    appendNumber(reply, idx / cols);
+                    appendNumber(reply, idx % cols);
+                    appendNumber(reply, cellValue(board.cell(idx / cols, idx % cols)));
+                }
+                changed.clear();
+            }
+        }
+        reply.push_back('\n');
+        out.write(reply.data(), static_cast<std::streamsize>(reply.size()));
+        // let pipelined requests share one flush
+        if (in.rdbuf()->in_avail() <= 0)
+            out.flush();
+    }
+    out.flush();
+    return 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <iosfwd>
+
+// Headless engine for external solvers (main --bot). Line protocol, one reply
+// line per request line:
+//   N seed rows cols mines   new game; mines are placed on the first reveal
+//   R r c / F r c / C r c    reveal (chords on a number), toggle flag, chord;
+//                            any number of them on one line form a batch
+//   Q                        quit
+// Replies are "status count r c v ..." listing only the cells that changed,
+// where status is P (playing), W (won) or L (lost) and v is 0-8 for a revealed
+// number, 9 flagged, 10 hidden, 11 revealed mine. A rejected line gets
+// "E reason" and changes nothing.
+int runBot(std::istream& in, std::ostream& out);
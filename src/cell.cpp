@@ -8,18 +8,6 @@ Cell::Cell(float x, float y, float size)
     setOutlineColor(sf::Color::Black);
 }
 
-void Cell::reveal() {
-    if (state == CellState::Hidden)
-        state = CellState::Revealed;
-}
-
-void Cell::toggleFlag() {
-    if (state == CellState::Hidden)
-        state = CellState::Flagged;
-    else if (state == CellState::Flagged)
-        state = CellState::Hidden;
-}
-
 bool Cell::isMine() const {
     return mine;
 }
@@ -38,4 +26,8 @@ void Cell::setAdjacentMines(int count) {
 
 CellState Cell::getState() const {
     return state;
+}
+
+void Cell::setState(CellState s) {
+    state = s;
 }
\ No newline at end of file
@@ -1,10 +1,82 @@
 #include "game.hpp"
+#include "alloc_counter.hpp"
 #include <cstdlib>
 #include <ctime>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+// board texel codes; digits are TexelEmpty + count, the shader below relies on these values
+enum BoardTexel : sf::Uint8 { TexelHidden = 0, TexelFlagged = 1, TexelEmpty = 2, TexelMine = 11 };
+const unsigned int AtlasTiles = 10; // flag, mine, digits 1-8
+
+// Expands the one-texel-per-cell state texture into the board: checker
+// pattern, revealed background, heatmap tint, atlas glyph and cell outline
+static const char* boardFragmentShader = R"(
+uniform sampler2D state;
+uniform sampler2D atlas;
+uniform vec2 boardSize;
+uniform float cellPixels;
+
+void main() {
+    vec2 pos = gl_TexCoord[0].xy * boardSize;
+    vec2 cell = floor(pos);
+    vec2 local = pos - cell;
+    vec4 texel = texture2D(state, (cell + 0.5) / boardSize);
+    float code = floor(texel.r * 255.0 + 0.5);
+    vec3 color;
+    float tile = -1.0;
+    if (code < 1.5) {
+        color = mod(cell.x + cell.y, 2.0) < 0.5 ? vec3(170.0, 215.0, 81.0) / 255.0 : vec3(162.0, 209.0, 73.0) / 255.0;
+        if (texel.b > 0.5)
+            color = mix(color, vec3(texel.g, 1.0 - texel.g, 0.0), 140.0 / 255.0);
+        if (code > 0.5)
+            tile = 0.0;
+    } else if (code > 10.5) {
+        color = vec3(1.0, 0.0, 0.0);
+        tile = 1.0;
+    } else {
+        color = vec3(200.0 / 255.0);
+        if (code > 2.5)
+            tile = code - 1.0;
+    }
+    if (tile >= 0.0) {
+        vec4 glyph = texture2D(atlas, vec2((tile + local.x) / 10.0, local.y));
+        color = mix(color, glyph.rgb, glyph.a);
+    }
+    vec2 px = local * cellPixels;
+    if (px.x < 1.0 || px.y < 1.0 || px.x > cellPixels - 1.0 || px.y > cellPixels - 1.0)
+        color = vec3(0.0);
+    gl_FragColor = vec4(color, 1.0);
+}
+)";
+
+const float MinimapPixels = 160.f; // longest minimap side
+
+// minimap class of a cell in the given state
+static Minimap::Category minimapCategory(bool mine, CellState state) {
+    if (state == CellState::Hidden) return Minimap::Hidden;
+    if (state == CellState::Flagged) return Minimap::Flagged;
+    return mine ? Minimap::Exploded : Minimap::Revealed;
+}
+
+// text color for a cell's adjacent mine count
+static sf::Color digitColor(int count) {
+    switch (count) {
+    case 1: return sf::Color::Blue;
+    case 2: return sf::Color(0, 128, 0);
+    case 3: return sf::Color(180, 0, 0);
+    case 4: return sf::Color(128, 0, 128);
+    case 5: return sf::Color(255, 105, 180);
+    case 6: return sf::Color(0, 255, 255);
+    case 7: return sf::Color::Black;
+    case 8: return sf::Color(128, 128, 128);
+    default: return sf::Color::White;
+    }
+}
 
 
 Game::Game(unsigned int rows, unsigned int cols, float cellSize, const std::string& bestTimeFile)
@@ -13,19 +85,32 @@ Game::Game(unsigned int rows, unsigned int cols, float cellSize, const std::stri
     , cellSize(cellSize)
     , gameOverFlag(false)
     , gameWonFlag(false)
-    , firstClick(true)
     , savedTime(0)
+    , finishSeconds(0.f)
     , bestTime(0)
     , fadeStarted(false)
     , fadeDuration(2.f)
     , bestTimeFile(bestTimeFile)
     , newRecord(false)
     , selectingDifficulty(false)
+    , showProbabilities(false)
+    , probabilitiesDirty(true)
+    , clicks(0)
+    , useBoardShader(false)
+    , boardTexelsStale(true)
+    , heatmapUploaded(false)
+    , practiceMode(false)
+    , practiceUsed(false)
+    , replayingHistory(false)
+    , movesApplied(0)
+    , animateReveals(false)
+    , revealBudget(sf::milliseconds(4))
+    , showMinimap(false)
 {
     std::srand(static_cast<unsigned>(std::time(nullptr)));
-    // Initialize mine/flag counters
-    totalMines = (rows * cols) / 6;
-    flagsUsed = 0;
+    board.setChangeCallback([this](unsigned int row, unsigned int col, CellState from, CellState to) {
+        cellChanged(row, col, from, to);
+    });
     // Load font for drawing numbers
     if (!font.loadFromFile("ARIAL.TTF")) {
         std::cerr << "Failed to load font ARIAL.TTF" << std::endl;
@@ -46,18 +131,16 @@ Game::Game(unsigned int rows, unsigned int cols, float cellSize, const std::stri
     if (!nudgeBuffer.loadFromFile("Nudge_Sound_Effect.wav")) {
         std::cerr << "Failed to load Nudge_Sound_Effect.wav" << std::endl;
     }
-    nudgeSound.setBuffer(nudgeBuffer);
+    nudgeSounds.setBuffer(nudgeBuffer);
     if (!popBuffer.loadFromFile("Pop.wav")) {
         std::cerr << "Failed to load Pop.wav" << std::endl;
     }
-    popSound.setBuffer(popBuffer);
-    // Load victory music
-    if (!victoryMusic.openFromFile("Victory_music.wav")) {
-        std::cerr << "Failed to load Victory_music.wav" << std::endl;
-    }
-    victoryMusic.setLoop(true);
+    popSounds.setBuffer(popBuffer);
     // create window after loading assets to prevent initial blank
     window.create(sf::VideoMode(cols * cellSize, rows * cellSize + static_cast<int>(cellSize)), "Minesweeper");
+    initTexts();
+    resetBoardView();
+    initBoardShader(); // single-draw board rendering when shaders are available
     initGrid();  // set up grid; delay mine placement until first click
     loadBestTime(); // load record best time from file: bestTimeFile
 }
@@ -66,11 +149,85 @@ void Game::run() {
     // initial render to set up UI element bounds
     render();
     while (window.isOpen()) {
+#ifdef MINESWEEPER_COUNT_ALLOCS
+        unsigned long allocationsBefore = allocationCount();
+#endif
+        processEvents();
+        update();
+        render();
+#ifdef MINESWEEPER_COUNT_ALLOCS
+        // report frames that touched the heap; idle frames should print nothing
+        unsigned long frameAllocations = allocationCount() - allocationsBefore;
+        if (frameAllocations > 0)
+            std::cerr << "frame allocations: " << frameAllocations << std::endl;
+#endif
+    }
+}
+
+#ifdef MINESWEEPER_COUNT_ALLOCS
+const unsigned int CascadeSeed = 8; // gives a large opening from the middle of the Hard board
+
+bool Game::checkFrameAllocations(unsigned int frames) {
+    // fixed seed, open the middle and flag the mines touching the opening
+    std::srand(1);
+    board.click(rows / 2, cols / 2);
+    for (unsigned int i = 0; i < rows; ++i)
+        for (unsigned int j = 0; j < cols; ++j)
+            if (board.cell(i, j).isMine() && board.cell(i, j).getState() == CellState::Hidden)
+                for (int di = -1; di <= 1; ++di)
+                    for (int dj = -1; dj <= 1; ++dj) {
+                        int ni = static_cast<int>(i) + di;
+                        int nj = static_cast<int>(j) + dj;
+                        if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols) &&
+                            board.cell(ni, nj).getState() == CellState::Revealed &&
+                            board.cell(i, j).getState() == CellState::Hidden)
+                            board.toggleFlag(i, j);
+                    }
+    showProbabilities = true;
+    showMinimap = true;
+    // a window smaller than the board, so the board scrolls and the minimap is drawn
+    window.setSize(sf::Vector2u(static_cast<unsigned int>(cols * cellSize / 2.f),
+                                static_cast<unsigned int>(rows * cellSize / 2.f + cellSize)));
+    resetBoardView();
+    // warm-up: the first frames upload textures and solve the heatmap, and
+    // timer digits are cached up front rather than as the seconds tick over
+    for (char digit = '0'; digit <= '9'; ++digit)
+        font.getGlyph(digit, timerText.getCharacterSize(), false);
+    for (int i = 0; i < 10; ++i) {
         processEvents();
         update();
         render();
     }
+    unsigned long allocationsBefore = allocationCount();
+    for (unsigned int i = 0; i < frames; ++i) {
+        processEvents();
+        update();
+        render();
+    }
+    unsigned long allocations = allocationCount() - allocationsBefore;
+    std::cout << allocations << " heap allocations in " << frames << " frames" << std::endl;
+
+    // animated cascade: a new board opened in the middle and drained frame by frame.
+    // The heatmap is off because re-solving it after a move allocates by design.
+    showProbabilities = false;
+    reset();
+    animateReveals = true;
+    board.setAnimated(true);
+    std::srand(CascadeSeed);
+    board.click(rows / 2, cols / 2); // mine placement and board metrics happen here, outside any frame
+    unsigned int cascadeFrames = 0;
+    allocationsBefore = allocationCount();
+    while (board.hasPendingReveals()) {
+        processEvents();
+        update();
+        render();
+        cascadeFrames++;
+    }
+    unsigned long cascadeAllocations = allocationCount() - allocationsBefore;
+    std::cout << cascadeAllocations << " heap allocations in " << cascadeFrames << " cascade frames" << std::endl;
+    return allocations == 0 && cascadeAllocations == 0;
 }
+#endif
 
 void Game::processEvents() {
     sf::Event event;
@@ -79,6 +236,38 @@ void Game::processEvents() {
             window.close();
             continue;
         }
+        // a window shrunk below the board scrolls it instead of squashing it
+        if (event.type == sf::Event::Resized) {
+            resetBoardView();
+            continue;
+        }
+        // toggle mine-probability heatmap
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+            showProbabilities = !showProbabilities;
+            continue;
+        }
+        // practice mode: U toggles it, Ctrl+Z undoes and Ctrl+Y (or Ctrl+Shift+Z) redoes
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::U) {
+            practiceMode = !practiceMode;
+            if (practiceMode) practiceUsed = true;
+            clearHistory();
+            continue;
+        }
+        // toggle animated cascades
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A) {
+            animateReveals = !animateReveals;
+            board.setAnimated(animateReveals);
+            continue;
+        }
+        // toggle minimap
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::M) {
+            showMinimap = !showMinimap;
+            continue;
+        }
+        if (event.type == sf::Event::KeyPressed && practiceMode && event.key.control) {
+            if (event.key.code == sf::Keyboard::Z && !event.key.shift) { undoMove(); continue; }
+            if (event.key.code == sf::Keyboard::Y || event.key.code == sf::Keyboard::Z) { redoMove(); continue; }
+        }
         // difficulty menu click handling
         if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
             sf::Vector2f click(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
@@ -95,6 +284,15 @@ void Game::processEvents() {
                 continue;
             }
         }
+        // the minimap takes every click inside it, so cells underneath are never hit by accident;
+        // a left click jumps the board view to the clicked spot
+        if (event.type == sf::Event::MouseButtonPressed && !selectingDifficulty
+            && minimapBounds.contains(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y))) {
+            if (event.mouseButton.button == sf::Mouse::Left)
+                centerBoardView((event.mouseButton.x - minimapBounds.left) / minimapBounds.width,
+                                (event.mouseButton.y - minimapBounds.top) / minimapBounds.height);
+            continue;
+        }
         // Handle retry click when game lost and after fade completion
         // Handle play/try again click after fade (for win or loss)
         if (event.type == sf::Event::MouseButtonPressed && gameOverFlag && fadeStarted 
@@ -109,74 +307,25 @@ void Game::processEvents() {
         // Handle mouse input for game actions
         if (event.type == sf::Event::MouseButtonPressed && !gameOverFlag) {
             auto mousePos = sf::Mouse::getPosition(window);
-            int mx = mousePos.x;
-            int my = mousePos.y;
+            // board coordinates under the cursor, through the scrollable board view
+            sf::Vector2f world = window.mapPixelToCoords(mousePos, boardView);
+            int mx = static_cast<int>(std::floor(world.x));
+            int my = static_cast<int>(std::floor(world.y));
             
-            if (mx >= 0 && mx < static_cast<int>(cols * cellSize) && my >= static_cast<int>(cellSize)) {
+            if (mousePos.y >= static_cast<int>(cellSize) &&
+                mx >= 0 && mx < static_cast<int>(cols * cellSize) && my >= static_cast<int>(cellSize)) {
                 unsigned int colIdx = mx / static_cast<int>(cellSize);
                 unsigned int rowIdx = (my - static_cast<int>(cellSize)) / static_cast<int>(cellSize);
                 if (rowIdx < rows && colIdx < cols) {
+                    clicks++;
+                    if (practiceMode) beginMove();
                     if (event.mouseButton.button == sf::Mouse::Left) {
-                        if (firstClick) {
-                            // First click: place mines and compute adjacents
-                            placeMines(rowIdx, colIdx);
-                            calculateAdjacents();
-                            firstClick = false;
-                            // clear any flags placed before game start
-                            flagsUsed = 0;
-                            for (auto& row : grid) {
-                                for (auto& cell : row) {
-                                    if (cell.getState() == CellState::Flagged) {
-                                        cell.toggleFlag();
-                                    }
-                                }
-                            }
-                            revealCell(rowIdx, colIdx);
-                        } else {
-                            Cell& cell = grid[rowIdx][colIdx];
-                            if (cell.getState() == CellState::Revealed && !cell.isMine() && cell.getAdjacentMines() > 0) {
-                                // Chord reveal neighbors when flags match
-                                int flagCount = 0;
-                                for (int di = -1; di <= 1; ++di) {
-                                    for (int dj = -1; dj <= 1; ++dj) {
-                                        if (di == 0 && dj == 0) continue;
-                                        int ni = static_cast<int>(rowIdx) + di;
-                                        int nj = static_cast<int>(colIdx) + dj;
-                                        if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols) &&
-                                            grid[ni][nj].getState() == CellState::Flagged) {
-                                            flagCount++;
-                                        }
-                                    }
-                                }
-                                if (flagCount == static_cast<int>(cell.getAdjacentMines())) {
-                                    for (int di = -1; di <= 1; ++di) {
-                                        for (int dj = -1; dj <= 1; ++dj) {
-                                            if (di == 0 && dj == 0) continue;
-                                            int ni = static_cast<int>(rowIdx) + di;
-                                            int nj = static_cast<int>(colIdx) + dj;
-                                            if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols) &&
-                                                grid[ni][nj].getState() == CellState::Hidden) {
-                                                revealCell(static_cast<unsigned int>(ni), static_cast<unsigned int>(nj));
-                                            }
-                                        }
-                                    }
-                                }
-                            } else {
-                                revealCell(rowIdx, colIdx);
-                            }
-                        }
+                        board.click(rowIdx, colIdx);
                     } else if (event.mouseButton.button == sf::Mouse::Right) {
-                        Cell& cell = grid[rowIdx][colIdx];
-                        if (cell.getState() == CellState::Hidden) {
-                            cell.toggleFlag();
-                            flagsUsed++;
-                            nudgeSound.play();
-                        } else if (cell.getState() == CellState::Flagged) {
-                            cell.toggleFlag();
-                            flagsUsed--;
-                            popSound.play();
-                        }
+                        flagClicked(rowIdx, colIdx);
                     }
+                    if (practiceMode) dropEmptyMove();
+                    checkOutcome();
                 }
             }
         } else if (event.type == sf::Event::MouseButtonPressed) {
@@ -190,58 +339,107 @@ void Game::processEvents() {
     }
 }
 
+// Right click on the board: toggle the flag and play its sound
+void Game::flagClicked(unsigned int row, unsigned int col) {
+    CellState before = board.cell(row, col).getState();
+    board.toggleFlag(row, col);
+    if (before == CellState::Hidden)
+        nudgeSounds.play();
+    else if (before == CellState::Flagged)
+        popSounds.play();
+}
+
+bool Game::checkFlagLatency(unsigned int toggles, sf::Time bound) {
+    const sf::Time interval = sf::milliseconds(20); // 50 toggles per second
+    sf::Time total = sf::Time::Zero;
+    sf::Time worst = sf::Time::Zero;
+    sf::Clock pace;
+    for (unsigned int i = 0; i < toggles; ++i) {
+        // walk the top row so flags are placed and removed, with many sounds still playing
+        unsigned int col = i % cols;
+        sf::Clock latency;
+        flagClicked(0, col);
+        sf::Time elapsed = latency.getElapsedTime();
+        total += elapsed;
+        if (elapsed > worst) worst = elapsed;
+        sf::Time next = interval * static_cast<sf::Int64>(i + 1);
+        if (pace.getElapsedTime() < next)
+            sf::sleep(next - pace.getElapsedTime());
+    }
+    std::cout << toggles << " flag toggles: mean " << (toggles > 0 ? total.asMicroseconds() / toggles : 0)
+              << " us, worst " << worst.asMicroseconds() << " us from event to play()" << std::endl;
+    return worst < bound;
+}
+
 void Game::update() {
+    // advance a pending cascade; it keeps going after a mine hit mid-chord
+    if (board.hasPendingReveals())
+        board.processReveals(animateReveals, revealBudget);
+    checkOutcome();
+}
+
+// End the game once the board is lost or cleared
+void Game::checkOutcome() {
     if (gameOverFlag)
         return;
-    // Check win condition: if all non-mine cells are revealed
-    bool allRevealed = true;
-    for (auto& row : grid) {
-        for (auto& cell : row) {
-            if (!cell.isMine() && cell.getState() != CellState::Revealed) {
-                allRevealed = false;
-                break;
-            }
+    if (board.hitMine()) {
+        gameOverFlag = true;
+        gameWonFlag = false;
+        // stop timer
+        finishSeconds = timer.getElapsedTime().asSeconds();
+        savedTime = static_cast<unsigned int>(finishSeconds);
+        prepareEndTexts();
+        // start fade animation on loss
+        if (!fadeStarted) {
+            fadeStarted = true;
+            fadeClock.restart();
         }
-        if (!allRevealed)
-            break;
+        return;
     }
-    if (allRevealed) {
+    // Check win condition: if all non-mine cells are revealed
+    if (board.isCleared()) {
         gameOverFlag = true;
         gameWonFlag = true; // mark win for in-window message
         // stop timer
-        savedTime = static_cast<unsigned int>(timer.getElapsedTime().asSeconds());
+        finishSeconds = timer.getElapsedTime().asSeconds();
+        savedTime = static_cast<unsigned int>(finishSeconds);
         // check for new best record
-        bool isNew = (bestTime == 0 || savedTime < bestTime);
+        // games that used practice mode never set records
+        bool isNew = !practiceUsed && (bestTime == 0 || savedTime < bestTime);
         newRecord = isNew;
         if (isNew) {
             bestTime = savedTime;
             saveBestTime();
         }
         std::cout << "You win!" << std::endl;
+        prepareEndTexts();
         // Reveal all mines to show win state
-        for (auto& row : grid)
-            for (auto& cell : row)
-                if (cell.isMine())
-                    cell.reveal();
-        // start fade animation and play victory music
+        board.revealMines();
+        // start fade animation
         if (!fadeStarted) {
             fadeStarted = true;
             fadeClock.restart();
-            victoryMusic.play();
         }
     }
 }
 
 void Game::render() {
     window.clear();
-   
-    sf::RectangleShape uiBar(sf::Vector2f(static_cast<float>(window.getSize().x), cellSize));
-    uiBar.setFillColor(sf::Color(94, 142, 60)); 
+    window.setView(uiView);
+    const float winW = static_cast<float>(window.getSize().x);
+    const float winH = static_cast<float>(window.getSize().y);
+
+    uiBar.setSize(sf::Vector2f(winW, cellSize));
+    // blue-green bar marks practice mode
+    uiBar.setFillColor(practiceMode ? sf::Color(60, 120, 142) : sf::Color(94, 142, 60)); 
     uiBar.setPosition(0.f, 0.f);
     window.draw(uiBar);
 
     {
+        unsigned int totalMines = board.getMineCount();
+        unsigned int flagsUsed = board.getFlagsUsed();
         unsigned int remaining = (totalMines > flagsUsed ? totalMines - flagsUsed : 0);
+        if (remaining > 999) remaining = 999;
         // flag icon
         sf::Sprite flagSprite(flagTexture);
         float charSize = cellSize * 0.5f;
@@ -256,11 +454,13 @@ void Game::render() {
         float cy = y - (iconH - charSize) / 2.f + verticalOffset;
         flagSprite.setPosition(uiX, cy);
         window.draw(flagSprite);
-        sf::Text countText;
-        countText.setFont(font);
-        countText.setString(std::to_string(remaining));
-        countText.setCharacterSize(static_cast<unsigned int>(charSize));
-        countText.setFillColor(sf::Color::White);
+        // at most three characters, which sf::String keeps inline; replaced only on change
+        if (remaining != shownRemaining) {
+            char countStr[4];
+            std::snprintf(countStr, sizeof(countStr), "%u", remaining);
+            countText.setString(countStr);
+            shownRemaining = remaining;
+        }
         sf::FloatRect bt = countText.getLocalBounds();
         float tx = uiX + iconW + 4.f;
         float ty = y + (charSize - bt.height) / 2.f - bt.top + verticalOffset;
@@ -278,16 +478,15 @@ void Game::render() {
         }
         if (secs > 999) secs = 999;
         // format as three digits
-        std::string timeStr = std::to_string(secs);
-        while (timeStr.length() < 3) timeStr = "0" + timeStr;
-        sf::Text timerText;
-        timerText.setFont(font);
-        timerText.setString(timeStr);
-        timerText.setCharacterSize(static_cast<unsigned int>(cellSize * 0.5f));
-        timerText.setFillColor(sf::Color::White);
+        if (secs != shownSecs) {
+            char timeStr[4];
+            std::snprintf(timeStr, sizeof(timeStr), "%03u", secs);
+            timerText.setString(timeStr);
+            shownSecs = secs;
+        }
         // position at top-right with padding
         sf::FloatRect tb = timerText.getLocalBounds();
-        float x = window.getSize().x - tb.width - 5.f - tb.left;
+        float x = winW - tb.width - 5.f - tb.left;
         float y = 5.f;
         // draw clock icon left of timer
         {
@@ -315,178 +514,91 @@ void Game::render() {
     }
     
     {
-        float textSize = cellSize * 0.5f;
         float pad = 8.f;
-        
-        sf::Text diffText("Mode", font, static_cast<unsigned int>(textSize));
-        diffText.setFillColor(sf::Color::White);
-        sf::FloatRect tb = diffText.getLocalBounds();
+        sf::FloatRect tb = modeText.getLocalBounds();
         float width = tb.width + pad * 2.f;
         float height = tb.height + pad * 2.f;
        
-        float btnX = (window.getSize().x - width) / 2.f;
+        float btnX = (winW - width) / 2.f;
         float btnY = (cellSize - height) / 2.f;
         
         //mode button
-        sf::Color btnColor = sf::Color::Black;
-        float r = pad; // corner radius
-        // horizontal center rectangle
-        sf::RectangleShape rectH(sf::Vector2f(width - 2 * r, height));
-        rectH.setFillColor(btnColor);
-        rectH.setPosition(btnX + r, btnY);
-        window.draw(rectH);
-        // vertical center rectangle
-        sf::RectangleShape rectV(sf::Vector2f(width, height - 2 * r));
-        rectV.setFillColor(btnColor);
-        rectV.setPosition(btnX, btnY + r);
-        window.draw(rectV);
-        // corner circles
-        const int cornerPoints = 20;
-        sf::CircleShape corner(r, cornerPoints);
-        corner.setFillColor(btnColor);
-        // top-left
-        corner.setPosition(btnX, btnY);
-        window.draw(corner);
-        // top-right
-        corner.setPosition(btnX + width - 2 * r, btnY);
-        window.draw(corner);
-        // bottom-left
-        corner.setPosition(btnX, btnY + height - 2 * r);
-        window.draw(corner);
-        // bottom-right
-        corner.setPosition(btnX + width - 2 * r, btnY + height - 2 * r);
-        window.draw(corner);
+        drawRoundedRect(btnX, btnY, width, height, pad, sf::Color::Black, 20);
        
         float textX = btnX + (width - tb.width) / 2.f - tb.left;
         float textY = btnY + (height - tb.height) / 2.f - tb.top;
-        diffText.setPosition(textX, textY);
-        window.draw(diffText);
+        modeText.setPosition(textX, textY);
+        window.draw(modeText);
         
         diffBounds = sf::FloatRect(btnX, 0.f, width, cellSize);
     }
-    for (unsigned int i = 0; i < rows; ++i) {
-        for (unsigned int j = 0; j < cols; ++j) {
-            Cell& cell = grid[i][j];
-            // Set color based on state
-            switch (cell.getState()) {
-            case CellState::Hidden:
-                // alternating hidden cell colors for checker pattern
-                if ((i + j) % 2 == 0)
-                    cell.setFillColor(sf::Color(170, 215, 81)); // lighter green shade
-                else
-                    cell.setFillColor(sf::Color(162, 209, 73)); // slightly darker light green shade
-                break;
-            case CellState::Flagged:
-                // keep hidden background for flagged
-                if ((i + j) % 2 == 0)
-                    cell.setFillColor(sf::Color(170, 215, 81));
-                else
-                    cell.setFillColor(sf::Color(162, 209, 73));
-                break;
-            case CellState::Revealed:
-                if (cell.isMine())
-                    cell.setFillColor(sf::Color::Red);
-                else
-                    cell.setFillColor(sf::Color(200, 200, 200));
-                break;
-            }
-            window.draw(cell);
-            // draw flag icon for flagged cells
-            if (cell.getState() == CellState::Flagged) {
-                sf::Sprite flagSprite(flagTexture);
-                // scale sprite to cell size
-                auto ts = flagTexture.getSize();
-                flagSprite.setScale(cellSize / ts.x, cellSize / ts.y);
-                flagSprite.setPosition(cell.getPosition());
-                window.draw(flagSprite);
-            }
-            // Draw adjacent mine count for revealed non-mine cells
-            if (cell.getState() == CellState::Revealed && !cell.isMine() && cell.getAdjacentMines() > 0) {
-                sf::Text text;
-                text.setFont(font);
-                text.setString(std::to_string(cell.getAdjacentMines()));
-                text.setCharacterSize(static_cast<unsigned int>(cellSize * 0.5f));
-                //set color based on number of adjacent mines
-                switch (cell.getAdjacentMines()) {
-                case 1: text.setFillColor(sf::Color::Blue); break;
-                case 2: text.setFillColor(sf::Color(0, 128, 0)); break; 
-                case 3: text.setFillColor(sf::Color(180, 0, 0)); break; 
-                case 4: text.setFillColor(sf::Color(128, 0, 128)); break;        
-                case 5: text.setFillColor(sf::Color(255, 105, 180)); break;        
-                case 6: text.setFillColor(sf::Color(0, 255, 255)); break;          
-                case 7: text.setFillColor(sf::Color::Black); break;
-                case 8: text.setFillColor(sf::Color(128, 128, 128)); break;  
-                default: text.setFillColor(sf::Color::White); break;
-                }
-                // Center text in cell
-                sf::FloatRect bounds = text.getLocalBounds();
-                float x = cell.getPosition().x + (cellSize - bounds.width) / 2.f;
-                float y = cell.getPosition().y + (cellSize - bounds.height) / 2.f - bounds.top;
-                text.setPosition(x, y);
-                window.draw(text);
-            }
-            // draw mine icon for revealed mines
-            if (cell.getState() == CellState::Revealed && cell.isMine()) {
-                sf::Sprite mineSprite(mineTexture);
-                auto mts = mineTexture.getSize();
-                mineSprite.setScale(cellSize / mts.x, cellSize / mts.y);
-                mineSprite.setPosition(cell.getPosition());
-                window.draw(mineSprite);
-            }
-        }
+    // refresh mine probabilities only when the board changed
+    bool drawHeatmap = showProbabilities && !gameOverFlag;
+    bool heatmapChanged = false;
+    if (drawHeatmap && probabilitiesDirty && !board.hasPendingReveals()) {
+        probabilities.update(board.getGrid(), board.getMineCount());
+        probabilitiesDirty = false;
+        heatmapChanged = true;
+    }
+    drawHeatmap = drawHeatmap && probabilities.isValid();
+    window.setView(boardView);
+    if (useBoardShader)
+        drawBoardShader(drawHeatmap, heatmapChanged);
+    else
+        drawCells(drawHeatmap);
+    window.setView(uiView);
+    changedCells.clear();
+    // minimap in the bottom-right corner, sized to the board's aspect ratio;
+    // only when the board is larger than its view, otherwise it would just cover cells
+    minimapBounds = sf::FloatRect();
+    if (showMinimap && !boardFitsView()) {
+        float side = std::min(MinimapPixels, winW / 3.f);
+        float longest = static_cast<float>(std::max(rows, cols));
+        float w = side * cols / longest;
+        float h = side * rows / longest;
+        minimapBounds = sf::FloatRect(winW - w - 8.f, winH - h - 8.f, w, h);
+        // visible part of the board as a fraction of the whole
+        sf::Vector2f center = boardView.getCenter();
+        sf::Vector2f size = boardView.getSize();
+        float boardW = cols * cellSize;
+        float boardH = rows * cellSize;
+        sf::FloatRect visible((center.x - size.x / 2.f) / boardW, (center.y - size.y / 2.f - cellSize) / boardH,
+                              std::min(size.x / boardW, 1.f), std::min(size.y / boardH, 1.f));
+        minimap.draw(window, minimapBounds, visible);
     }
     // apply fade overlay if win fade started
     if (fadeStarted) {
         float elapsed = fadeClock.getElapsedTime().asSeconds();
         float t = elapsed / fadeDuration;
         if (t > 1.f) t = 1.f;
-        sf::RectangleShape overlay(sf::Vector2f(static_cast<float>(window.getSize().x), static_cast<float>(window.getSize().y)));
+        overlay.setSize(sf::Vector2f(winW, winH));
         overlay.setPosition(0.f, 0.f);
         overlay.setFillColor(sf::Color(0, 0, 0, static_cast<sf::Uint8>(150 * t)));
         window.draw(overlay);
     }
     // If game is over, show message
     if (gameOverFlag) {
-        sf::Text msg;
-        msg.setFont(font);
-        msg.setString(gameWonFlag ? "You Win!" : "Game Over");
-        msg.setCharacterSize(static_cast<unsigned int>(cellSize));
-        msg.setFillColor(sf::Color::White);
         // Center message
-        sf::FloatRect bounds = msg.getLocalBounds();
-        float x = (window.getSize().x - bounds.width) / 2.f - bounds.left;
-        float y = (window.getSize().y - bounds.height) / 2.f - bounds.top;
-        msg.setPosition(x, y);
-        window.draw(msg);
-        // display best time when won
+        sf::FloatRect bounds = messageText.getLocalBounds();
+        float x = (winW - bounds.width) / 2.f - bounds.left;
+        float y = (winH - bounds.height) / 2.f - bounds.top;
+        messageText.setPosition(x, y);
+        window.draw(messageText);
+        // display best time and efficiency when won
         if (gameWonFlag) {
-            sf::Text bestText;
-            bestText.setFont(font);
-            unsigned int btime = bestTime;
-            std::string bestStr = std::to_string(btime);
-            while (bestStr.length() < 3) bestStr = "0" + bestStr;
-            // display "New best!" when record beaten, else show best time
-            if (newRecord) {
-                bestText.setString(std::string("New best: ") + bestStr);
-            } else {
-                bestText.setString(std::string("Best: ") + bestStr);
-            }
-            bestText.setCharacterSize(static_cast<unsigned int>(cellSize * 0.5f));
-            bestText.setFillColor(sf::Color::White);
             sf::FloatRect bb = bestText.getLocalBounds();
-            float bx = (window.getSize().x - bb.width) / 2.f - bb.left;
-            float by = msg.getPosition().y + msg.getCharacterSize() + 5.f;
+            float bx = (winW - bb.width) / 2.f - bb.left;
+            float by = y + messageText.getCharacterSize() + 5.f;
             bestText.setPosition(bx, by);
             window.draw(bestText);
+            sf::FloatRect sb = statsText.getLocalBounds();
+            float sx = (winW - sb.width) / 2.f - sb.left;
+            float sy = by + bestText.getCharacterSize() + 5.f;
+            statsText.setPosition(sx, sy);
+            window.draw(statsText);
         }
         // draw button after game over (Play Again on win, Try Again on loss)
         if (fadeStarted && fadeClock.getElapsedTime().asSeconds() >= fadeDuration) {
-            // button label and size
-            std::string label = gameWonFlag ? "Play Again" : "Try Again";
-            sf::Text retryText;
-            retryText.setFont(font);
-            retryText.setString(label);
-            retryText.setCharacterSize(static_cast<unsigned int>(cellSize * 0.5f));
             // compute text bounds
             sf::FloatRect tb = retryText.getLocalBounds();
             // padding and dimensions
@@ -494,46 +606,21 @@ void Game::render() {
             float padY = 8.f;
             float w = tb.width + padX * 2.f;
             float h = tb.height + padY * 2.f;
-            float r = padY; // corner radius
             // button origin centered horizontally, below message
-            float x0 = (window.getSize().x - w) / 2.f;
+            float x0 = (winW - w) / 2.f;
             float y0;
             if (gameWonFlag) {
-                // position below best time text: msg + msg size + small gap + best text size + extra padding
-                y0 = msg.getPosition().y + msg.getCharacterSize() + 5.f
-                    + static_cast<float>(cellSize * 0.5f) + 20.f;
+                // position below best time and stats text: msg + msg size + small gaps + text sizes + extra padding
+                y0 = y + messageText.getCharacterSize() + 5.f
+                    + static_cast<float>(cellSize * 0.5f) + 5.f
+                    + static_cast<float>(cellSize * 0.4f) + 20.f;
             } else {
                
-                y0 = msg.getPosition().y + msg.getCharacterSize() + 30.f;
+                y0 = y + messageText.getCharacterSize() + 30.f;
             }
+            drawRoundedRect(x0, y0, w, h, padY, sf::Color(50, 50, 50, 200), 50);
             // position text inside button
             retryText.setPosition(x0 + padX - tb.left, y0 + padY - tb.top);
-            // center rectangle (horizontal)
-            sf::RectangleShape rectH(sf::Vector2f(w - 2*r, h));
-            rectH.setFillColor(sf::Color(50, 50, 50, 200));
-            rectH.setPosition(x0 + r, y0);
-            window.draw(rectH);
-            // center rectangle (vertical)
-            sf::RectangleShape rectV(sf::Vector2f(w, h - 2*r));
-            rectV.setFillColor(sf::Color(50, 50, 50, 200));
-            rectV.setPosition(x0, y0 + r);
-            window.draw(rectV);
-            // corner circles
-            sf::CircleShape corner(r, 50);
-            corner.setFillColor(sf::Color(50, 50, 50, 200));
-            // top-left
-            corner.setPosition(x0, y0);
-            window.draw(corner);
-            // top-right
-            corner.setPosition(x0 + w - 2*r, y0);
-            window.draw(corner);
-            // bottom-left
-            corner.setPosition(x0, y0 + h - 2*r);
-            window.draw(corner);
-            // bottom-right
-            corner.setPosition(x0 + w - 2*r, y0 + h - 2*r);
-            window.draw(corner);
-            // text
             window.draw(retryText);
             // store bounds for click detection
             retryBounds = sf::FloatRect(x0, y0, w, h);
@@ -542,17 +629,16 @@ void Game::render() {
     // Render difficulty selection overlay on top if active
     if (selectingDifficulty) {
         // darken background
-        sf::RectangleShape overlay(sf::Vector2f((float)window.getSize().x, (float)window.getSize().y));
+        overlay.setSize(sf::Vector2f(winW, winH));
+        overlay.setPosition(0.f, 0.f);
         overlay.setFillColor(sf::Color(0, 0, 0, 180));
         window.draw(overlay);
         // draw menu options
-        std::vector<std::string> opts = {"Easy", "Medium", "Hard"};
-        float baseY = window.getSize().y * 0.4f;
+        float baseY = winH * 0.4f;
         for (int i = 0; i < 3; ++i) {
-            sf::Text optText(opts[i], font, static_cast<unsigned int>(cellSize * 0.6f));
-            optText.setFillColor(sf::Color::White);
+            sf::Text& optText = optionTexts[i];
             sf::FloatRect lb = optText.getLocalBounds();
-            float tx = (window.getSize().x - lb.width) / 2.f - lb.left;
+            float tx = (winW - lb.width) / 2.f - lb.left;
             float ty = baseY + i * (lb.height + 20.f) - lb.top;
             optText.setPosition(tx, ty);
             window.draw(optText);
@@ -565,130 +651,450 @@ void Game::render() {
     window.display();
 }
 
-void Game::initGrid() {
-    grid.clear();
-    grid.reserve(rows);
+// Rounded button body: two crossing rectangles plus four corner circles
+void Game::drawRoundedRect(float x, float y, float w, float h, float r, const sf::Color& color, unsigned int cornerPoints) {
+    // horizontal center rectangle
+    buttonH.setSize(sf::Vector2f(w - 2 * r, h));
+    buttonH.setFillColor(color);
+    buttonH.setPosition(x + r, y);
+    window.draw(buttonH);
+    // vertical center rectangle
+    buttonV.setSize(sf::Vector2f(w, h - 2 * r));
+    buttonV.setFillColor(color);
+    buttonV.setPosition(x, y + r);
+    window.draw(buttonV);
+    // corner circles
+    buttonCorner.setRadius(r);
+    buttonCorner.setPointCount(cornerPoints);
+    buttonCorner.setFillColor(color);
+    // top-left
+    buttonCorner.setPosition(x, y);
+    window.draw(buttonCorner);
+    // top-right
+    buttonCorner.setPosition(x + w - 2 * r, y);
+    window.draw(buttonCorner);
+    // bottom-left
+    buttonCorner.setPosition(x, y + h - 2 * r);
+    window.draw(buttonCorner);
+    // bottom-right
+    buttonCorner.setPosition(x + w - 2 * r, y + h - 2 * r);
+    window.draw(buttonCorner);
+}
+
+// Fixed labels and glyphs are built once; per-frame drawing only moves them
+void Game::initTexts() {
+    unsigned int textSize = static_cast<unsigned int>(cellSize * 0.5f);
+    countText.setFont(font);
+    countText.setCharacterSize(textSize);
+    countText.setFillColor(sf::Color::White);
+    timerText.setFont(font);
+    timerText.setCharacterSize(textSize);
+    timerText.setFillColor(sf::Color::White);
+    shownRemaining = shownSecs = ~0u; // force the first update
+    modeText.setFont(font);
+    modeText.setString("Mode");
+    modeText.setCharacterSize(textSize);
+    modeText.setFillColor(sf::Color::White);
+    messageText.setFont(font);
+    messageText.setCharacterSize(static_cast<unsigned int>(cellSize));
+    messageText.setFillColor(sf::Color::White);
+    bestText.setFont(font);
+    bestText.setCharacterSize(textSize);
+    bestText.setFillColor(sf::Color::White);
+    statsText.setFont(font);
+    statsText.setCharacterSize(static_cast<unsigned int>(cellSize * 0.4f));
+    statsText.setFillColor(sf::Color::White);
+    retryText.setFont(font);
+    retryText.setCharacterSize(textSize);
+    retryText.setFillColor(sf::Color::White);
+    static const char* const difficultyNames[3] = {"Easy", "Medium", "Hard"};
+    for (int i = 0; i < 3; ++i) {
+        optionTexts[i].setFont(font);
+        optionTexts[i].setString(difficultyNames[i]);
+        optionTexts[i].setCharacterSize(static_cast<unsigned int>(cellSize * 0.6f));
+        optionTexts[i].setFillColor(sf::Color::White);
+    }
+    const char digits[] = "012345678";
+    for (int n = 1; n <= 8; ++n) {
+        char digit[2] = {digits[n], '\0'};
+        cellDigits[n].setFont(font);
+        cellDigits[n].setString(digit);
+        cellDigits[n].setCharacterSize(textSize);
+        cellDigits[n].setFillColor(digitColor(n));
+    }
+    heatShape.setSize(sf::Vector2f(cellSize, cellSize));
+}
+
+// Fill in the game-over texts once, when the game ends
+void Game::prepareEndTexts() {
+    messageText.setString(gameWonFlag ? "You Win!" : "Game Over");
+    retryText.setString(gameWonFlag ? "Play Again" : "Try Again");
+    if (!gameWonFlag) return;
+    // display "New best!" when record beaten, else show best time
+    char bestStr[32];
+    std::snprintf(bestStr, sizeof(bestStr), newRecord ? "New best: %03u" : "Best: %03u", bestTime);
+    bestText.setString(bestStr);
+    // efficiency: 3BV per second and 3BV per click
+    // exact finish time; whole seconds would overstate the rate on quick clears
+    float secs = finishSeconds > 0.f ? finishSeconds : 1.f;
+    const BoardMetrics& metrics = board.getMetrics();
+    unsigned int efficiency = clicks > 0 ? (metrics.bbbv * 100) / clicks : 0;
+    char statsStr[64];
+    std::snprintf(statsStr, sizeof(statsStr), "3BV/s: %.2f  Eff: %u%%", metrics.bbbv / secs, efficiency);
+    statsText.setString(statsStr);
+}
+
+// Per-cell board drawing, used when shaders are unavailable
+void Game::drawCells(bool drawHeatmap) {
     for (unsigned int i = 0; i < rows; ++i) {
-        std::vector<Cell> rowCells;
-        rowCells.reserve(cols);
         for (unsigned int j = 0; j < cols; ++j) {
-            // shift all cells down by cellSize to make room for top UI bar
-            rowCells.emplace_back(j * cellSize, i * cellSize + cellSize, cellSize);
+            Cell& cell = board.cell(i, j);
+            // Set color based on state
+            switch (cell.getState()) {
+            case CellState::Hidden:
+                // alternating hidden cell colors for checker pattern
+                if ((i + j) % 2 == 0)
+                    cell.setFillColor(sf::Color(170, 215, 81)); // lighter green shade
+                else
+                    cell.setFillColor(sf::Color(162, 209, 73)); // slightly darker light green shade
+                break;
+            case CellState::Flagged:
+                // keep hidden background for flagged
+                if ((i + j) % 2 == 0)
+                    cell.setFillColor(sf::Color(170, 215, 81));
+                else
+                    cell.setFillColor(sf::Color(162, 209, 73));
+                break;
+            case CellState::Revealed:
+                if (cell.isMine())
+                    cell.setFillColor(sf::Color::Red);
+                else
+                    cell.setFillColor(sf::Color(200, 200, 200));
+                break;
+            }
+            window.draw(cell);
+            // shade hidden cells from green (safe) to red (certain mine)
+            float p = probabilities.at(i, j);
+            if (drawHeatmap && cell.getState() == CellState::Hidden && p >= 0.f) {
+                heatShape.setFillColor(sf::Color(static_cast<sf::Uint8>(255 * p), static_cast<sf::Uint8>(255 * (1.f - p)), 0, 140));
+                heatShape.setPosition(cell.getPosition());
+                window.draw(heatShape);
+            }
+            // draw flag icon for flagged cells
+            if (cell.getState() == CellState::Flagged) {
+                sf::Sprite flagSprite(flagTexture);
+                // scale sprite to cell size
+                auto ts = flagTexture.getSize();
+                flagSprite.setScale(cellSize / ts.x, cellSize / ts.y);
+                flagSprite.setPosition(cell.getPosition());
+                window.draw(flagSprite);
+            }
+            // Draw adjacent mine count for revealed non-mine cells
+            if (cell.getState() == CellState::Revealed && !cell.isMine() && cell.getAdjacentMines() > 0) {
+                sf::Text& text = cellDigits[cell.getAdjacentMines()];
+                // Center text in cell
+                sf::FloatRect bounds = text.getLocalBounds();
+                float x = cell.getPosition().x + (cellSize - bounds.width) / 2.f;
+                float y = cell.getPosition().y + (cellSize - bounds.height) / 2.f - bounds.top;
+                text.setPosition(x, y);
+                window.draw(text);
+            }
+            // draw mine icon for revealed mines
+            if (cell.getState() == CellState::Revealed && cell.isMine()) {
+                sf::Sprite mineSprite(mineTexture);
+                auto mts = mineTexture.getSize();
+                mineSprite.setScale(cellSize / mts.x, cellSize / mts.y);
+                mineSprite.setPosition(cell.getPosition());
+                window.draw(mineSprite);
+            }
         }
-        grid.push_back(std::move(rowCells));
     }
 }
 
-// Load the best time from a file
-// Load the best time from the configured file
-void Game::loadBestTime() {
-    std::ifstream fin(bestTimeFile);
-    if (fin) {
-        unsigned int t;
-        if (fin >> t) bestTime = t;
+// Draw the whole board in one call: the state texture holds one texel per
+// cell and the fragment shader expands it into backgrounds and glyphs
+void Game::drawBoardShader(bool drawHeatmap, bool heatmapChanged) {
+    if (heatmapChanged || drawHeatmap != heatmapUploaded) {
+        boardTexelsStale = true;
+        heatmapUploaded = drawHeatmap;
+    }
+    unsigned int firstRow = rows;
+    unsigned int lastRow = 0;
+    if (boardTexelsStale) {
+        for (unsigned int i = 0; i < rows; ++i)
+            for (unsigned int j = 0; j < cols; ++j)
+                encodeTexel(i, j);
+        firstRow = 0;
+        lastRow = rows - 1;
+        boardTexelsStale = false;
+    } else {
+        // re-encode only the cells changed since the last frame
+        for (unsigned int idx : changedCells) {
+            unsigned int r = idx / cols;
+            encodeTexel(r, idx % cols);
+            if (r < firstRow) firstRow = r;
+            if (r > lastRow) lastRow = r;
+        }
     }
+    // upload the band of full rows that contains every changed texel
+    if (firstRow <= lastRow)
+        boardStateTexture.update(&boardTexels[firstRow * cols * 4], cols, lastRow - firstRow + 1, 0, firstRow);
+
+    sf::Sprite boardSprite(boardStateTexture);
+    boardSprite.setScale(cellSize, cellSize);
+    boardSprite.setPosition(0.f, cellSize);
+    window.draw(boardSprite, &boardShader);
 }
 
-// Save the best time to the configured file
-void Game::saveBestTime() {
-    std::ofstream fout(bestTimeFile, std::ios::trunc);
-    if (fout) fout << bestTime;
+// Pack a cell into its texel: red = appearance code, green = heat, blue = heat shown
+void Game::encodeTexel(unsigned int row, unsigned int col) {
+    const Cell& cell = board.cell(row, col);
+    sf::Uint8 code = TexelHidden;
+    if (cell.getState() == CellState::Flagged)
+        code = TexelFlagged;
+    else if (cell.getState() == CellState::Revealed)
+        code = cell.isMine() ? TexelMine : static_cast<sf::Uint8>(TexelEmpty + cell.getAdjacentMines());
+    sf::Uint8* texel = &boardTexels[(row * cols + col) * 4];
+    texel[0] = code;
+    texel[1] = 0;
+    texel[2] = 0;
+    texel[3] = 255;
+    float p = probabilities.at(row, col);
+    if (heatmapUploaded && cell.getState() == CellState::Hidden && p >= 0.f) {
+        texel[1] = static_cast<sf::Uint8>(255 * p);
+        texel[2] = 255;
+    }
 }
 
-// Place mines randomly, excluding the first-clicked safe cell and its neighbors
-void Game::placeMines(unsigned int safeRow, unsigned int safeCol) {
-    unsigned int placed = 0;
-    while (placed < totalMines) {
-        unsigned int r = std::rand() % rows;
-        unsigned int c = std::rand() % cols;
-        // skip the safe cell, its neighbors, and already mined cells
-        if (grid[r][c].isMine() ||
-            (std::abs(static_cast<int>(r) - static_cast<int>(safeRow)) <= 1 &&
-             std::abs(static_cast<int>(c) - static_cast<int>(safeCol)) <= 1)) {
-            continue;
-        }
-        grid[r][c].setMine(true);
-        placed++;
+// Build the glyph atlas and compile the board shader; on failure the per-cell path is used
+void Game::initBoardShader() {
+    useBoardShader = false;
+    if (!sf::Shader::isAvailable()) {
+        std::cerr << "Shaders unavailable, using per-cell rendering" << std::endl;
+        return;
+    }
+    if (!boardShader.loadFromMemory(boardFragmentShader, sf::Shader::Fragment)) {
+        std::cerr << "Failed to compile board shader, using per-cell rendering" << std::endl;
+        return;
+    }
+    // atlas tiles, one cell wide each: flag, mine, digits 1-8
+    unsigned int tile = static_cast<unsigned int>(cellSize);
+    sf::RenderTexture atlas;
+    if (!atlas.create(tile * AtlasTiles, tile)) {
+        std::cerr << "Failed to create glyph atlas, using per-cell rendering" << std::endl;
+        return;
+    }
+    atlas.clear(sf::Color::Transparent);
+    sf::Sprite flagSprite(flagTexture);
+    auto fts = flagTexture.getSize();
+    flagSprite.setScale(cellSize / fts.x, cellSize / fts.y);
+    atlas.draw(flagSprite);
+    sf::Sprite mineSprite(mineTexture);
+    auto mts = mineTexture.getSize();
+    mineSprite.setScale(cellSize / mts.x, cellSize / mts.y);
+    mineSprite.setPosition(cellSize, 0.f);
+    atlas.draw(mineSprite);
+    for (int n = 1; n <= 8; ++n) {
+        sf::Text text = cellDigits[n];
+        // same centering as the per-cell path
+        sf::FloatRect bounds = text.getLocalBounds();
+        float x = (n + 1) * cellSize + (cellSize - bounds.width) / 2.f;
+        float y = (cellSize - bounds.height) / 2.f - bounds.top;
+        text.setPosition(x, y);
+        atlas.draw(text);
     }
+    atlas.display();
+    if (!boardAtlas.loadFromImage(atlas.getTexture().copyToImage())) {
+        std::cerr << "Failed to load glyph atlas, using per-cell rendering" << std::endl;
+        return;
+    }
+    boardShader.setUniform("state", sf::Shader::CurrentTexture);
+    boardShader.setUniform("atlas", boardAtlas);
+    boardShader.setUniform("cellPixels", cellSize);
+    useBoardShader = true;
 }
 
-void Game::calculateAdjacents() {
-    for (unsigned int i = 0; i < rows; ++i) {
-        for (unsigned int j = 0; j < cols; ++j) {
-            if (grid[i][j].isMine()) {
-                grid[i][j].setAdjacentMines(-1);
-                continue;
-            }
-            int count = 0;
-            for (int di = -1; di <= 1; ++di) {
-                for (int dj = -1; dj <= 1; ++dj) {
-                    if (di == 0 && dj == 0) continue;
-                    int ni = static_cast<int>(i) + di;
-                    int nj = static_cast<int>(j) + dj;
-                    if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols)) {
-                        if (grid[ni][nj].isMine()) count++;
-                    }
-                }
-            }
-            grid[i][j].setAdjacentMines(count);
+// Board change callback: log for undo and keep the board texture and minimap in sync
+void Game::cellChanged(unsigned int row, unsigned int col, CellState from, CellState to) {
+    if (practiceMode && !replayingHistory && movesApplied > 0) {
+        // a change after an undo starts a new branch: drop the redo tail
+        if (movesApplied < moves.size()) {
+            moves.resize(movesApplied);
+            changeLog.resize(moves.back().end);
         }
+        changeLog.push_back({row * cols + col, from, to});
+        moves.back().end = changeLog.size();
     }
+    bool mine = board.cell(row, col).isMine();
+    minimap.cellChanged(row, col, minimapCategory(mine, from), minimapCategory(mine, to));
+    changedCells.push_back(row * cols + col);
+    probabilitiesDirty = true;
 }
 
-void Game::revealCell(unsigned int row, unsigned int col) {
-    Cell& cell = grid[row][col];
-    if (cell.getState() != CellState::Hidden) return;
-    cell.reveal();
-    // If it's a mine, game over
-    if (cell.isMine()) {
-        gameOverFlag = true;
-        gameWonFlag = false;
-        // reveal all mines
-        for (auto& r : grid)
-            for (auto& c : r)
-                if (c.isMine()) c.reveal();
-        // stop timer
-        savedTime = static_cast<unsigned int>(timer.getElapsedTime().asSeconds());
-        // start fade animation on loss
-        if (!fadeStarted) {
-            fadeStarted = true;
-            fadeClock.restart();
-        }
-        return;
+// Fit the views to the window size: the UI at one unit per pixel and the board
+// below the UI bar, starting at the top-left corner
+void Game::resetBoardView() {
+    float winW = static_cast<float>(window.getSize().x);
+    float winH = static_cast<float>(window.getSize().y);
+    uiView.reset(sf::FloatRect(0.f, 0.f, winW, winH));
+    boardView.reset(sf::FloatRect(0.f, cellSize, winW, winH - cellSize));
+    boardView.setViewport(sf::FloatRect(0.f, cellSize / winH, 1.f, (winH - cellSize) / winH));
+    centerBoardView(0.f, 0.f);
+}
+
+bool Game::boardFitsView() const {
+    return boardView.getSize().x >= cols * cellSize && boardView.getSize().y >= rows * cellSize;
+}
+
+// Center the board view on a fractional board position, clamped to the board edges
+void Game::centerBoardView(float fx, float fy) {
+    float boardW = cols * cellSize;
+    float boardH = rows * cellSize;
+    sf::Vector2f half(boardView.getSize().x / 2.f, boardView.getSize().y / 2.f);
+    float x = fx * boardW;
+    float y = fy * boardH;
+    x = boardW <= 2.f * half.x ? boardW / 2.f : std::min(std::max(x, half.x), boardW - half.x);
+    y = boardH <= 2.f * half.y ? boardH / 2.f : std::min(std::max(y, half.y), boardH - half.y);
+    boardView.setCenter(x, y + cellSize);
+}
+
+// Open a new undo step; following cell changes are logged into it
+void Game::beginMove() {
+    board.processReveals(false); // the previous move's cascade belongs to the previous move
+    dropEmptyMove();
+    moves.resize(movesApplied);
+    changeLog.resize(moves.empty() ? 0 : moves.back().end);
+    MoveRecord move;
+    move.begin = move.end = changeLog.size();
+    move.flagsBefore = move.flagsAfter = board.getFlagsUsed();
+    move.overBefore = move.overAfter = gameOverFlag;
+    move.wonBefore = move.wonAfter = gameWonFlag;
+    moves.push_back(move);
+    movesApplied = moves.size();
+}
+
+// Forget the newest move once it has turned out to change nothing, so undo
+// never lands on an empty step; a pending cascade may still fill it
+void Game::dropEmptyMove() {
+    if (movesApplied == 0 || movesApplied != moves.size() || board.hasPendingReveals()) return;
+    const MoveRecord& move = moves.back();
+    if (move.begin == move.end && move.flagsBefore == board.getFlagsUsed()) {
+        moves.pop_back();
+        movesApplied--;
     }
-    // Only auto-reveal neighbors if this cell has no adjacent mines
-    if (cell.getAdjacentMines() == 0) {
-        revealNeighbors(row, col);
+}
+
+// Revert the last applied move; cost is proportional to the cells it changed
+void Game::undoMove() {
+    board.processReveals(false); // finish any cascade before rewinding
+    dropEmptyMove();
+    if (movesApplied == 0) return;
+    MoveRecord& move = moves[movesApplied - 1];
+    move.flagsAfter = board.getFlagsUsed();
+    move.overAfter = gameOverFlag;
+    move.wonAfter = gameWonFlag;
+    replayingHistory = true;
+    for (std::size_t k = move.end; k > move.begin; --k) {
+        const CellChange& change = changeLog[k - 1];
+        board.setCellState(change.index / cols, change.index % cols, change.from);
     }
+    replayingHistory = false;
+    board.setFlagsUsed(move.flagsBefore);
+    setOutcome(move.overBefore, move.wonBefore);
+    movesApplied--;
 }
 
-void Game::revealNeighbors(unsigned int row, unsigned int col) {
-    for (int di = -1; di <= 1; ++di) {
-        for (int dj = -1; dj <= 1; ++dj) {
-            if (di == 0 && dj == 0) continue;
-            int ni = static_cast<int>(row) + di;
-            int nj = static_cast<int>(col) + dj;
-            if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols)) {
-                if (grid[ni][nj].getState() == CellState::Hidden && !grid[ni][nj].isMine()) {
-                    revealCell(ni, nj);
-                }
-            }
+// Re-apply the next undone move
+void Game::redoMove() {
+    board.processReveals(false);
+    if (movesApplied == moves.size()) return;
+    const MoveRecord& move = moves[movesApplied];
+    replayingHistory = true;
+    for (std::size_t k = move.begin; k < move.end; ++k) {
+        const CellChange& change = changeLog[k];
+        board.setCellState(change.index / cols, change.index % cols, change.to);
+    }
+    replayingHistory = false;
+    board.setFlagsUsed(move.flagsAfter);
+    setOutcome(move.overAfter, move.wonAfter);
+    movesApplied++;
+}
+
+// Switch between playing and finished states when history is replayed
+void Game::setOutcome(bool over, bool won) {
+    if (over && !gameOverFlag) {
+        finishSeconds = timer.getElapsedTime().asSeconds();
+        savedTime = static_cast<unsigned int>(finishSeconds);
+        fadeStarted = true;
+        fadeClock.restart();
+    } else if (!over) {
+        fadeStarted = false;
+    }
+    gameOverFlag = over;
+    gameWonFlag = won;
+    if (over) prepareEndTexts();
+}
+
+void Game::clearHistory() {
+    changeLog.clear();
+    moves.clear();
+    movesApplied = 0;
+}
+
+void Game::initGrid() {
+    // shift all cells down by cellSize to make room for top UI bar
+    board.reset(rows, cols, (rows * cols) / 6, cellSize, cellSize);
+    board.setAnimated(animateReveals);
+    minimap.reset(rows, cols, static_cast<unsigned int>(MinimapPixels));
+    // one RGBA texel per cell for the shader path
+    boardTexels.assign(rows * cols * 4, 0);
+    changedCells.clear();
+    changedCells.reserve(rows * cols); // a cascade frame can change every cell
+    boardTexelsStale = true;
+    if (useBoardShader) {
+        if (boardStateTexture.create(cols, rows)) {
+            boardShader.setUniform("boardSize", sf::Glsl::Vec2(static_cast<float>(cols), static_cast<float>(rows)));
+        } else {
+            std::cerr << "Failed to create board texture, using per-cell rendering" << std::endl;
+            useBoardShader = false;
         }
     }
 }
+
+// Load the best time from a file
+// Load the best time from the configured file
+void Game::loadBestTime() {
+    std::ifstream fin(bestTimeFile);
+    if (fin) {
+        unsigned int t;
+        if (fin >> t) bestTime = t;
+    }
+}
+
+// Save the best time to the configured file
+void Game::saveBestTime() {
+    std::ofstream fout(bestTimeFile, std::ios::trunc);
+    if (fout) fout << bestTime;
+}
+
 // Reset the game state for a new playthrough
 void Game::reset() {
     gameOverFlag = false;
     gameWonFlag = false;
-    firstClick = true;
-    flagsUsed = 0;
     savedTime = 0;
+    finishSeconds = 0.f;
+    clicks = 0;
+    practiceUsed = practiceMode;
     fadeStarted = false;
     timer.restart();
-    // stop victory music if playing
-    victoryMusic.stop();
+    // stop any flag sounds still playing
+    nudgeSounds.stop();
+    popSounds.stop();
     // reinitialize grid
     initGrid();
+    clearHistory();
+    probabilities.clear();
+    probabilitiesDirty = true;
 }
 // apply a new difficulty setting and restart game
 void Game::applyDifficulty(int choice) {
@@ -710,19 +1116,25 @@ void Game::applyDifficulty(int choice) {
     }
     // recreate window
     window.create(sf::VideoMode(cols * cellSize, rows * cellSize + static_cast<int>(cellSize)), "Minesweeper");
-    totalMines = (rows * cols) / 6;
+    resetBoardView();
     // reset state
     gameOverFlag = false;
     gameWonFlag = false;
-    firstClick = true;
-    flagsUsed = 0;
     savedTime = 0;
+    finishSeconds = 0.f;
+    clicks = 0;
+    practiceUsed = practiceMode;
     bestTime = 0;
     newRecord = false;
     fadeStarted = false;
     selectingDifficulty = false;
     timer.restart();
+    nudgeSounds.stop();
+    popSounds.stop();
     fadeClock.restart();
     initGrid();
+    clearHistory();
+    probabilities.clear();
+    probabilitiesDirty = true;
     loadBestTime();
 }
\ No newline at end of file
@@ -4,45 +4,68 @@
 #include <vector>
 #include <string>
 #include "cell.hpp"
+#include "probability.hpp"
+#include "board.hpp"
+#include "minimap.hpp"
+#include "sound_pool.hpp"
 #include <SFML/Audio.hpp>
 
 class Game {
 public:
     Game(unsigned int rows, unsigned int cols, float cellSize, const std::string& bestTimeFile);
     void run();
+#ifdef MINESWEEPER_COUNT_ALLOCS
+    // render frames of a mid-game board; true when none of them allocated
+    bool checkFrameAllocations(unsigned int frames);
+#endif
+    // toggle flags at 50 per second and time each one from the event to the play() call;
+    // true when the slowest stays under the bound
+    bool checkFlagLatency(unsigned int toggles, sf::Time bound);
 
 private:
     void processEvents();
     void update();
     void render();
     void initGrid();
-    void placeMines(unsigned int safeRow, unsigned int safeCol); //Place mines on first click, excluding the first clicked cell
-    void calculateAdjacents();
-    void revealCell(unsigned int row, unsigned int col);
-    void revealNeighbors(unsigned int row, unsigned int col);
+    void checkOutcome();
+    void flagClicked(unsigned int row, unsigned int col);
+    void cellChanged(unsigned int row, unsigned int col, CellState from, CellState to);
+    void drawCells(bool drawHeatmap);
+    void drawBoardShader(bool drawHeatmap, bool heatmapChanged);
+    void initBoardShader();
+    void encodeTexel(unsigned int row, unsigned int col);
+    void beginMove();
+    void dropEmptyMove();
+    void undoMove();
+    void redoMove();
+    void setOutcome(bool over, bool won);
+    void clearHistory();
+    void drawRoundedRect(float x, float y, float w, float h, float r, const sf::Color& color, unsigned int cornerPoints);
+    void initTexts();
+    void prepareEndTexts();
+    void resetBoardView();
+    void centerBoardView(float fx, float fy);
+    bool boardFitsView() const; // whole board visible, so the minimap has nothing to show
 
     sf::RenderWindow window;
     sf::Font font;
     sf::Texture flagTexture;  // texture for flag icon
     sf::Texture clockTexture; // texture for clock icon
     sf::Texture mineTexture;  // texture for revealed mine icon
-    // audio buffers and sounds for flag actions
+    // audio clips, decoded into memory at startup, and the voices that play them
     sf::SoundBuffer nudgeBuffer;
-    sf::Sound nudgeSound;
     sf::SoundBuffer popBuffer;
-    sf::Sound popSound;
-    sf::Music victoryMusic;
+    SoundPool nudgeSounds; // flag placed
+    SoundPool popSounds;   // flag removed
     sf::Clock timer;  
-    std::vector<std::vector<Cell>> grid;
+    Board board; // game rules and cells
     unsigned int rows;
     unsigned int cols;
     float cellSize;
     bool gameOverFlag;
     bool gameWonFlag;
-    unsigned int totalMines;  
-    unsigned int flagsUsed;    
-    bool firstClick;          
     unsigned int savedTime;   
+    float finishSeconds;      // savedTime before rounding down, for 3BV/s
     unsigned int bestTime;
     std::string bestTimeFile; 
     bool newRecord;          
@@ -58,4 +81,57 @@ private:
     sf::FloatRect diffBounds;       // bounds of difficulty button
     sf::FloatRect easyRect, mediumRect, hardRect; // menu option bounds
     void applyDifficulty(int choice);
+    // mine-probability heatmap overlay, toggled with P
+    ProbabilityMap probabilities;
+    bool showProbabilities;
+    bool probabilitiesDirty; // board changed since the last update
+    unsigned int clicks; // board clicks this game, for click efficiency
+    // single-draw board rendering; the per-cell path is the fallback
+    bool useBoardShader;
+    sf::Shader boardShader;
+    sf::Texture boardStateTexture;    // one texel per cell
+    sf::Texture boardAtlas;           // flag, mine and digit glyphs
+    std::vector<sf::Uint8> boardTexels;
+    std::vector<unsigned int> changedCells; // cells whose state changed since the last frame
+    bool boardTexelsStale;            // whole texture needs re-encoding
+    bool heatmapUploaded;             // texels currently carry heatmap values
+    // practice mode: unlimited undo/redo stored as a log of cell changes,
+    // so a step costs memory proportional to the cells it touched
+    struct CellChange {
+        unsigned int index; // row * cols + col
+        CellState from;
+        CellState to;
+    };
+    struct MoveRecord {
+        std::size_t begin, end; // range in changeLog
+        unsigned int flagsBefore, flagsAfter;
+        bool overBefore, overAfter;
+        bool wonBefore, wonAfter;
+    };
+    bool practiceMode;
+    bool practiceUsed;     // practice mode was on at some point this game, so no record
+    bool replayingHistory; // undo/redo in progress, do not log
+    std::vector<CellChange> changeLog;
+    std::vector<MoveRecord> moves;
+    std::size_t movesApplied; // moves[0, movesApplied) are on the board
+    // animated mode drains the board's reveal queue across frames
+    bool animateReveals;
+    sf::Time revealBudget; // per-frame reveal time in animated mode
+    // persistent drawables, so steady-state frames do not allocate
+    sf::RectangleShape uiBar;
+    sf::RectangleShape overlay;
+    sf::RectangleShape heatShape;
+    sf::RectangleShape buttonH, buttonV; // rounded button body
+    sf::CircleShape buttonCorner;
+    sf::Text countText, timerText, modeText;
+    sf::Text messageText, bestText, statsText, retryText; // set by prepareEndTexts
+    sf::Text optionTexts[3];
+    sf::Text cellDigits[9]; // adjacent mine counts 1-8
+    unsigned int shownRemaining, shownSecs; // values currently in countText and timerText
+    sf::View uiView; // window pixels, follows resizes
+    // board view below the UI bar and the corner minimap that moves it
+    sf::View boardView;
+    Minimap minimap;
+    bool showMinimap;
+    sf::FloatRect minimapBounds; // window area of the minimap, for clicks; empty when hidden
 };
\ No newline at end of file
@@ -1,8 +1,30 @@
 #include "game.hpp"
+#include "bot.hpp"
 #include <iostream>
 #include <string>
 
-int main() {
+int main(int argc, char* argv[]) {
+    // headless mode for solvers: the board engine over stdin/stdout, no window
+    if (argc > 1 && std::string(argv[1]) == "--bot") {
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+        return runBot(std::cin, std::cout);
+    }
+    // steady-state allocation check on a mid-game Hard board; exits non-zero if any frame allocated
+    if (argc > 1 && std::string(argv[1]) == "--alloc-check") {
+#ifdef MINESWEEPER_COUNT_ALLOCS
+        Game game(19, 19, 64.f, "best_time_hard.txt");
+        return game.checkFrameAllocations(1000) ? 0 : 1;
+#else
+        std::cerr << "--alloc-check needs a build with -DMINESWEEPER_COUNT_ALLOCS" << std::endl;
+        return 1;
+#endif
+    }
+    // flag sound latency at 50 toggles per second; exits non-zero if any took a millisecond or more
+    if (argc > 1 && std::string(argv[1]) == "--sound-check") {
+        Game game(19, 19, 64.f, "best_time_hard.txt");
+        return game.checkFlagLatency(500, sf::milliseconds(1)) ? 0 : 1;
+    }
     // Start game in Easy mode; use in-game button to change difficulty
     const unsigned int rows = 10;
     const unsigned int cols = 10;
@@ -11,4 +33,4 @@ int main() {
     Game game(rows, cols, cellSize, bestTimeFile);
     game.run();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,72 @@
+#include "metrics.hpp"
+
+namespace {
+
+enum CellClass : unsigned char { Other, Opening, Island };
+
+unsigned int findRoot(std::vector<unsigned int>& parent, unsigned int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+BoardMetrics computeBoardMetrics(const std::vector<std::vector<Cell>>& grid) {
+    BoardMetrics metrics;
+    const unsigned int rows = static_cast<unsigned int>(grid.size());
+    const unsigned int cols = rows > 0 ? static_cast<unsigned int>(grid[0].size()) : 0;
+    const std::size_t size = static_cast<std::size_t>(rows) * cols;
+    std::vector<unsigned char> cls(size, Other);
+    std::vector<unsigned int> parent(size);
+    unsigned int openingCells = 0, islandCells = 0;
+    unsigned int openingUnions = 0, islandUnions = 0;
+
+    for (unsigned int i = 0; i < rows; ++i) {
+        for (unsigned int j = 0; j < cols; ++j) {
+            const Cell& cell = grid[i][j];
+            if (cell.isMine()) continue;
+            unsigned int idx = i * cols + j;
+            // zeros form openings; numbers touching no zero each need their own click
+            CellClass c = Opening;
+            if (cell.getAdjacentMines() > 0) {
+                c = Island;
+                for (int di = -1; di <= 1 && c == Island; ++di) {
+                    for (int dj = -1; dj <= 1; ++dj) {
+                        int ni = static_cast<int>(i) + di;
+                        int nj = static_cast<int>(j) + dj;
+                        if (ni >= 0 && ni < static_cast<int>(rows) && nj >= 0 && nj < static_cast<int>(cols) &&
+                            grid[ni][nj].getAdjacentMines() == 0) {
+                            c = Other;
+                            break;
+                        }
+                    }
+                }
+                if (c == Other) continue;
+            }
+            cls[idx] = c;
+            parent[idx] = idx;
+            if (c == Opening) openingCells++; else islandCells++;
+            // join with the already visited neighbours: west, north-west, north, north-east
+            const int back[4][2] = {{0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+            for (const auto& d : back) {
+                int ni = static_cast<int>(i) + d[0];
+                int nj = static_cast<int>(j) + d[1];
+                if (ni < 0 || nj < 0 || nj >= static_cast<int>(cols)) continue;
+                unsigned int nidx = ni * cols + nj;
+                if (cls[nidx] != c) continue;
+                unsigned int a = findRoot(parent, idx);
+                unsigned int b = findRoot(parent, nidx);
+                if (a == b) continue;
+                parent[a] = b;
+                if (c == Opening) openingUnions++; else islandUnions++;
+            }
+        }
+    }
+    metrics.openings = openingCells - openingUnions;
+    metrics.islands = islandCells - islandUnions;
+    metrics.bbbv = metrics.openings + islandCells;
+    return metrics;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+#include "cell.hpp"
+
+// Difficulty measures of a generated board
+struct BoardMetrics {
+    unsigned int bbbv = 0;     // 3BV: minimum number of left clicks to clear the board
+    unsigned int openings = 0; // connected regions of cells with no adjacent mines
+    unsigned int islands = 0;  // connected groups of numbers not bordering an opening
+};
+
+// Single union-find pass over the board after mines and adjacents are set; linear in cell count
+BoardMetrics computeBoardMetrics(const std::vector<std::vector<Cell>>& grid);
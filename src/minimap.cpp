@@ -0,0 +1,127 @@
+#include "minimap.hpp"
+
+namespace {
+
+// the finest stored level has at most this many blocks, keeping huge boards small in memory
+const unsigned int MaxBaseBlocks = 1u << 18;
+
+const sf::Color CategoryColors[Minimap::CategoryCount] = {
+    sf::Color(200, 200, 200), // revealed
+    sf::Color(162, 209, 73),  // hidden
+    sf::Color(230, 40, 40),   // flagged
+    sf::Color(60, 0, 0),      // exploded
+};
+
+unsigned int blocksAlong(unsigned int cells, unsigned int shift) {
+    return (cells + (1u << shift) - 1) >> shift;
+}
+
+} // namespace
+
+void Minimap::reset(unsigned int rows, unsigned int cols, unsigned int maxPixels) {
+    levels.clear();
+    unsigned int shift = 0;
+    while (static_cast<unsigned long long>(blocksAlong(rows, shift)) * blocksAlong(cols, shift) > MaxBaseBlocks)
+        shift++;
+    // every block starts fully hidden; partial blocks sit on the bottom and right edges
+    for (;; ++shift) {
+        Level level;
+        level.shift = shift;
+        level.rows = blocksAlong(rows, shift);
+        level.cols = blocksAlong(cols, shift);
+        level.counts.assign(static_cast<std::size_t>(level.rows) * level.cols, Counts{});
+        unsigned int size = 1u << shift;
+        for (unsigned int r = 0; r < level.rows; ++r) {
+            unsigned int h = (r + 1 == level.rows) ? rows - r * size : size;
+            for (unsigned int c = 0; c < level.cols; ++c) {
+                unsigned int w = (c + 1 == level.cols) ? cols - c * size : size;
+                level.counts[r * level.cols + c][Hidden] = h * w;
+            }
+        }
+        levels.push_back(std::move(level));
+        if (levels.back().rows <= 1 && levels.back().cols <= 1)
+            break;
+    }
+    displayLevel = 0;
+    while (displayLevel + 1 < levels.size() &&
+           (levels[displayLevel].rows > maxPixels || levels[displayLevel].cols > maxPixels))
+        displayLevel++;
+
+    const Level& shown = levels[displayLevel];
+    std::size_t blocks = static_cast<std::size_t>(shown.rows) * shown.cols;
+    pixels.assign(blocks * 4, 0);
+    dirty.clear();
+    dirty.reserve(blocks);
+    dirtyFlag.assign(blocks, 0);
+    for (std::size_t i = 0; i < blocks; ++i)
+        encodeBlock(static_cast<unsigned int>(i));
+    texture.create(shown.cols, shown.rows);
+    stale = true;
+    visibleFrame.setFillColor(sf::Color::Transparent);
+    visibleFrame.setOutlineColor(sf::Color::White);
+    visibleFrame.setOutlineThickness(1.f);
+}
+
+void Minimap::cellChanged(unsigned int row, unsigned int col, Category from, Category to) {
+    if (levels.empty() || from == to) return;
+    for (unsigned int l = 0; l < levels.size(); ++l) {
+        Level& level = levels[l];
+        unsigned int index = (row >> level.shift) * level.cols + (col >> level.shift);
+        level.counts[index][from]--;
+        level.counts[index][to]++;
+        if (l == displayLevel && !dirtyFlag[index]) {
+            dirtyFlag[index] = 1;
+            dirty.push_back(index);
+        }
+    }
+}
+
+// Block color: state colors weighted by how many cells of the block are in each state
+void Minimap::encodeBlock(unsigned int index) {
+    const Counts& counts = levels[displayLevel].counts[index];
+    unsigned int total = 0;
+    unsigned int r = 0, g = 0, b = 0;
+    for (int k = 0; k < CategoryCount; ++k) {
+        total += counts[k];
+        r += counts[k] * CategoryColors[k].r;
+        g += counts[k] * CategoryColors[k].g;
+        b += counts[k] * CategoryColors[k].b;
+    }
+    sf::Uint8* px = &pixels[static_cast<std::size_t>(index) * 4];
+    px[0] = static_cast<sf::Uint8>(total ? r / total : 0);
+    px[1] = static_cast<sf::Uint8>(total ? g / total : 0);
+    px[2] = static_cast<sf::Uint8>(total ? b / total : 0);
+    px[3] = 255;
+}
+
+void Minimap::draw(sf::RenderTarget& target, const sf::FloatRect& area, const sf::FloatRect& visible) {
+    if (levels.empty()) return;
+    const Level& shown = levels[displayLevel];
+    // re-encode changed blocks and upload the band of rows holding them
+    unsigned int firstRow = shown.rows;
+    unsigned int lastRow = 0;
+    if (stale) {
+        firstRow = 0;
+        lastRow = shown.rows - 1;
+        stale = false;
+    }
+    for (unsigned int index : dirty) {
+        encodeBlock(index);
+        dirtyFlag[index] = 0;
+        unsigned int r = index / shown.cols;
+        if (r < firstRow) firstRow = r;
+        if (r > lastRow) lastRow = r;
+    }
+    dirty.clear();
+    if (firstRow <= lastRow)
+        texture.update(&pixels[static_cast<std::size_t>(firstRow) * shown.cols * 4], shown.cols, lastRow - firstRow + 1, 0, firstRow);
+
+    sf::Sprite sprite(texture);
+    sprite.setScale(area.width / shown.cols, area.height / shown.rows);
+    sprite.setPosition(area.left, area.top);
+    target.draw(sprite);
+    // outline the part of the board currently in view; visible is a fraction of the board
+    visibleFrame.setPosition(area.left + visible.left * area.width, area.top + visible.top * area.height);
+    visibleFrame.setSize(sf::Vector2f(visible.width * area.width, visible.height * area.height));
+    target.draw(visibleFrame);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+
+// Downsampled overview of the board, backed by a mip pyramid of per-block
+// state counts that is updated in place as cells change
+class Minimap {
+public:
+    enum Category : unsigned char { Revealed, Hidden, Flagged, Exploded, CategoryCount };
+    // start a new board with every cell hidden; the displayed level fits in maxPixels per side
+    void reset(unsigned int rows, unsigned int cols, unsigned int maxPixels);
+    // O(levels): adjust the count of the block containing the cell at every level
+    void cellChanged(unsigned int row, unsigned int col, Category from, Category to);
+    // upload blocks changed since the last draw, then draw into area with the visible part outlined
+    void draw(sf::RenderTarget& target, const sf::FloatRect& area, const sf::FloatRect& visible);
+
+private:
+    typedef std::array<unsigned int, CategoryCount> Counts;
+    struct Level {
+        unsigned int shift; // blocks are (1 << shift) cells per side
+        unsigned int rows, cols;
+        std::vector<Counts> counts;
+    };
+    void encodeBlock(unsigned int index);
+
+    std::vector<Level> levels; // finest stored level first, single root block last
+    unsigned int displayLevel = 0;
+    sf::Texture texture;
+    std::vector<sf::Uint8> pixels;     // RGBA per block of the displayed level
+    std::vector<unsigned int> dirty;   // displayed blocks changed since the last draw
+    std::vector<char> dirtyFlag;
+    bool stale = true;                 // whole texture needs uploading
+    sf::RectangleShape visibleFrame;
+};
@@ -0,0 +1,362 @@
+#include "probability.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <thread>
+
+namespace {
+
+// polynomial product; coefficient k is the weight of configurations with k mines
+std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> out(a.size() + b.size() - 1, 0.0);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0.0) continue;
+        for (std::size_t j = 0; j < b.size(); ++j)
+            out[i + j] += a[i] * b[j];
+    }
+    return out;
+}
+
+// log of the binomial coefficient C(n, k)
+double logChoose(int n, int k) {
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+int findRoot(std::vector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+void ProbabilityMap::clear() {
+    cache.clear();
+    probs.clear();
+    cols = 0;
+    valid = false;
+}
+
+bool ProbabilityMap::isValid() const {
+    return valid;
+}
+
+float ProbabilityMap::at(unsigned int row, unsigned int col) const {
+    std::size_t idx = static_cast<std::size_t>(row) * cols + col;
+    if (!valid || idx >= probs.size()) return -1.f;
+    return probs[idx];
+}
+
+// Count the mine configurations of one component by walking its cells in
+// breadth-first order. Partial assignments are memoized on the mines each
+// number still needs, so branches that reach the same state are merged; a
+// forward and a backward pass then give the per-cell weights.
+ProbabilityMap::ComponentResult ProbabilityMap::enumerate(const Component& comp) {
+    typedef std::vector<unsigned char> State;
+    typedef std::vector<double> Poly;
+    const int n = static_cast<int>(comp.cells.size());
+    const int m = static_cast<int>(comp.constraints.size());
+
+    std::vector<std::vector<int>> cellConstraints(n);
+    for (int c = 0; c < m; ++c)
+        for (int i : comp.constraints[c].cells)
+            cellConstraints[i].push_back(c);
+
+    // breadth-first order keeps few numbers open at any step
+    std::vector<int> order;
+    std::vector<int> pos(n, -1);
+    std::deque<int> queue;
+    queue.push_back(0);
+    pos[0] = 0;
+    while (!queue.empty()) {
+        int i = queue.front();
+        queue.pop_front();
+        order.push_back(i);
+        for (int c : cellConstraints[i]) {
+            for (int j : comp.constraints[c].cells) {
+                if (pos[j] < 0) {
+                    pos[j] = 0;
+                    queue.push_back(j);
+                }
+            }
+        }
+    }
+    for (int p = 0; p < n; ++p) pos[order[p]] = p;
+
+    // per step: the numbers touching that cell and how many of their cells come later
+    std::vector<std::vector<std::pair<int, int>>> touch(n);
+    for (int p = 0; p < n; ++p) {
+        for (int c : cellConstraints[order[p]]) {
+            int after = 0;
+            for (int j : comp.constraints[c].cells)
+                if (pos[j] > p) after++;
+            touch[p].push_back({c, after});
+        }
+    }
+    auto advance = [&](const State& s, int p, int v, State& out) {
+        out = s;
+        for (const auto& t : touch[p]) {
+            if (v) {
+                if (out[t.first] == 0) return false;
+                out[t.first]--;
+            }
+            if (out[t.first] > t.second) return false;
+        }
+        return true;
+    };
+    // rescale a layer to keep weights in range; returns the log of the factor
+    auto normalize = [](std::map<State, Poly>& layer) {
+        double peak = 0.0;
+        for (const auto& e : layer)
+            for (double w : e.second) peak = std::max(peak, w);
+        if (peak <= 0.0) return 0.0;
+        for (auto& e : layer)
+            for (double& w : e.second) w /= peak;
+        return std::log(peak);
+    };
+
+    ComponentResult result;
+    result.total.assign(n + 1, 0.0);
+    result.mineWeight.assign(n, Poly(n + 1, 0.0));
+
+    State init(m);
+    for (int c = 0; c < m; ++c) init[c] = static_cast<unsigned char>(comp.constraints[c].value);
+    State next;
+
+    // forward pass: weight of every reachable state after the first p cells
+    std::vector<std::map<State, Poly>> forward(n + 1);
+    std::vector<double> logForward(n + 1, 0.0);
+    forward[0][init] = Poly(n + 1, 0.0);
+    forward[0][init][0] = 1.0;
+    for (int p = 0; p < n; ++p) {
+        for (const auto& e : forward[p]) {
+            for (int v = 0; v <= 1; ++v) {
+                if (!advance(e.first, p, v, next)) continue;
+                Poly& dst = forward[p + 1][next];
+                if (dst.empty()) dst.assign(n + 1, 0.0);
+                for (int k = 0; k + v <= n; ++k)
+                    dst[k + v] += e.second[k];
+            }
+        }
+        if (forward[p + 1].empty()) return result; // numbers cannot be satisfied
+        logForward[p + 1] = logForward[p] + normalize(forward[p + 1]);
+    }
+
+    // backward pass: weight of completing the board from each reachable state
+    std::vector<std::map<State, Poly>> backward(n + 1);
+    std::vector<double> logBackward(n + 1, 0.0);
+    backward[n] = forward[n];
+    for (auto& e : backward[n]) {
+        std::fill(e.second.begin(), e.second.end(), 0.0);
+        e.second[0] = 1.0;
+    }
+    for (int p = n - 1; p >= 0; --p) {
+        for (const auto& e : forward[p]) {
+            Poly weight(n + 1, 0.0);
+            for (int v = 0; v <= 1; ++v) {
+                if (!advance(e.first, p, v, next)) continue;
+                auto it = backward[p + 1].find(next);
+                if (it == backward[p + 1].end()) continue;
+                for (int k = 0; k + v <= n; ++k)
+                    weight[k + v] += it->second[k];
+            }
+            backward[p][e.first] = weight;
+        }
+        logBackward[p] = logBackward[p + 1] + normalize(backward[p]);
+    }
+
+    for (const auto& e : forward[n])
+        for (int k = 0; k <= n; ++k) result.total[k] += e.second[k];
+    double peak = *std::max_element(result.total.begin(), result.total.end());
+    if (peak <= 0.0) return result;
+    for (double& w : result.total) w /= peak;
+
+    for (int p = 0; p < n; ++p) {
+        Poly& weight = result.mineWeight[order[p]];
+        for (const auto& e : forward[p]) {
+            if (!advance(e.first, p, 1, next)) continue;
+            auto it = backward[p + 1].find(next);
+            if (it == backward[p + 1].end()) continue;
+            for (int a = 0; a < n; ++a) {
+                if (e.second[a] == 0.0) continue;
+                for (int b = 0; a + b + 1 <= n; ++b)
+                    weight[a + b + 1] += e.second[a] * it->second[b];
+            }
+        }
+        double scale = std::exp(logForward[p] + logBackward[p + 1] - logForward[n]) / peak;
+        for (double& w : weight) w *= scale;
+    }
+    return result;
+}
+
+void ProbabilityMap::update(const std::vector<std::vector<Cell>>& grid, unsigned int totalMines) {
+    valid = false;
+    const int rowCount = static_cast<int>(grid.size());
+    const int colCount = rowCount > 0 ? static_cast<int>(grid[0].size()) : 0;
+    cols = static_cast<unsigned int>(colCount);
+    const int size = rowCount * colCount;
+    probs.assign(size, -1.f);
+    if (size == 0) return;
+
+    // gather the numbers bordering hidden cells; flags and revealed mines count as mines
+    struct RawConstraint { int center; int value; std::vector<int> cells; };
+    std::vector<RawConstraint> raw;
+    int knownMines = 0;
+    std::vector<int> parent(size);
+    for (int idx = 0; idx < size; ++idx) parent[idx] = idx;
+    for (int i = 0; i < rowCount; ++i) {
+        for (int j = 0; j < colCount; ++j) {
+            const Cell& cell = grid[i][j];
+            if (cell.getState() == CellState::Flagged || (cell.getState() == CellState::Revealed && cell.isMine())) {
+                knownMines++;
+                continue;
+            }
+            if (cell.getState() != CellState::Revealed || cell.getAdjacentMines() < 0)
+                continue;
+            RawConstraint rc{i * colCount + j, cell.getAdjacentMines(), {}};
+            for (int di = -1; di <= 1; ++di) {
+                for (int dj = -1; dj <= 1; ++dj) {
+                    if (di == 0 && dj == 0) continue;
+                    int ni = i + di;
+                    int nj = j + dj;
+                    if (ni < 0 || ni >= rowCount || nj < 0 || nj >= colCount) continue;
+                    const Cell& n = grid[ni][nj];
+                    if (n.getState() == CellState::Hidden)
+                        rc.cells.push_back(ni * colCount + nj);
+                    else if (n.getState() == CellState::Flagged || n.isMine())
+                        rc.value--;
+                }
+            }
+            if (rc.value < 0 || rc.value > static_cast<int>(rc.cells.size())) return;
+            if (rc.cells.empty()) continue;
+            for (std::size_t k = 1; k < rc.cells.size(); ++k)
+                parent[findRoot(parent, rc.cells[k])] = findRoot(parent, rc.cells[0]);
+            raw.push_back(std::move(rc));
+        }
+    }
+    int minesLeft = static_cast<int>(totalMines) - knownMines;
+    if (minesLeft < 0) return;
+
+    // split the frontier into independent components
+    std::vector<char> frontier(size, 0);
+    for (const auto& rc : raw)
+        for (int idx : rc.cells) frontier[idx] = 1;
+    std::vector<int> compOf(size, -1);
+    std::vector<int> local(size, -1);
+    std::vector<Component> comps;
+    int interior = 0;
+    for (int idx = 0; idx < size; ++idx) {
+        if (grid[idx / colCount][idx % colCount].getState() != CellState::Hidden) continue;
+        if (!frontier[idx]) {
+            interior++;
+            continue;
+        }
+        int root = findRoot(parent, idx);
+        if (compOf[root] < 0) {
+            compOf[root] = static_cast<int>(comps.size());
+            comps.emplace_back();
+        }
+        Component& comp = comps[compOf[root]];
+        local[idx] = static_cast<int>(comp.cells.size());
+        comp.cells.push_back(idx);
+    }
+    for (const auto& rc : raw) {
+        Component& comp = comps[compOf[findRoot(parent, rc.cells[0])]];
+        Constraint c{rc.value, {}};
+        for (int idx : rc.cells) c.cells.push_back(local[idx]);
+        comp.constraints.push_back(std::move(c));
+        comp.key.push_back(rc.center);
+        comp.key.push_back(rc.value);
+    }
+    for (auto& comp : comps) {
+        comp.key.push_back(-1);
+        comp.key.insert(comp.key.end(), comp.cells.begin(), comp.cells.end());
+    }
+
+    // enumerate components whose cells or numbers changed, in parallel
+    std::vector<int> pending;
+    for (int c = 0; c < static_cast<int>(comps.size()); ++c)
+        if (cache.find(comps[c].key) == cache.end()) pending.push_back(c);
+    std::vector<ComponentResult> computed(pending.size());
+    unsigned int workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min<unsigned int>(workers, static_cast<unsigned int>(pending.size()));
+    std::atomic<std::size_t> nextJob(0);
+    auto work = [&]() {
+        for (std::size_t k = nextJob++; k < pending.size(); k = nextJob++)
+            computed[k] = enumerate(comps[pending[k]]);
+    };
+    if (workers <= 1) {
+        work();
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < workers; ++t) threads.emplace_back(work);
+        for (auto& t : threads) t.join();
+    }
+    // keep only the components that are still on the board
+    std::map<std::vector<int>, ComponentResult> nextCache;
+    for (std::size_t k = 0; k < pending.size(); ++k)
+        nextCache[comps[pending[k]].key] = std::move(computed[k]);
+    for (const auto& comp : comps) {
+        if (nextCache.count(comp.key)) continue;
+        auto it = cache.find(comp.key);
+        nextCache[comp.key] = std::move(it->second);
+    }
+    cache.swap(nextCache);
+
+    // combine components: prefix/suffix products give the mine-count
+    // distribution of everything except a given component
+    const std::size_t k = comps.size();
+    std::vector<const ComponentResult*> results(k);
+    for (std::size_t c = 0; c < k; ++c) results[c] = &cache[comps[c].key];
+    std::vector<std::vector<double>> prefix(k + 1), suffix(k + 1);
+    prefix[0] = {1.0};
+    suffix[k] = {1.0};
+    for (std::size_t c = 0; c < k; ++c) prefix[c + 1] = convolve(prefix[c], results[c]->total);
+    for (std::size_t c = k; c > 0; --c) suffix[c - 1] = convolve(suffix[c], results[c - 1]->total);
+    const std::vector<double>& all = prefix[k];
+
+    // the remaining mines are spread uniformly over the interior: weight C(interior, minesLeft - t)
+    std::vector<double> weight(all.size(), 0.0);
+    double peakLog = -std::numeric_limits<double>::infinity();
+    for (std::size_t t = 0; t < all.size(); ++t) {
+        int rest = minesLeft - static_cast<int>(t);
+        if (all[t] > 0.0 && rest >= 0 && rest <= interior)
+            peakLog = std::max(peakLog, logChoose(interior, rest));
+    }
+    if (std::isinf(peakLog)) return;
+    double norm = 0.0;
+    double interiorMines = 0.0;
+    for (std::size_t t = 0; t < all.size(); ++t) {
+        int rest = minesLeft - static_cast<int>(t);
+        if (rest < 0 || rest > interior) continue;
+        weight[t] = std::exp(logChoose(interior, rest) - peakLog);
+        norm += all[t] * weight[t];
+        interiorMines += all[t] * weight[t] * rest;
+    }
+    if (norm <= 0.0) return;
+
+    for (std::size_t c = 0; c < k; ++c) {
+        std::vector<double> rest = convolve(prefix[c], suffix[c + 1]);
+        const ComponentResult& res = *results[c];
+        // g[m]: weight of the rest of the board given m mines in this component
+        std::vector<double> g(res.total.size(), 0.0);
+        for (std::size_t m = 0; m < g.size(); ++m)
+            for (std::size_t r = 0; r < rest.size() && m + r < weight.size(); ++r)
+                g[m] += rest[r] * weight[m + r];
+        for (std::size_t i = 0; i < comps[c].cells.size(); ++i) {
+            double p = 0.0;
+            for (std::size_t m = 0; m < g.size(); ++m)
+                p += res.mineWeight[i][m] * g[m];
+            probs[comps[c].cells[i]] = static_cast<float>(p / norm);
+        }
+    }
+    float interiorProb = interior > 0 ? static_cast<float>(interiorMines / norm / interior) : 0.f;
+    for (int idx = 0; idx < size; ++idx)
+        if (grid[idx / colCount][idx % colCount].getState() == CellState::Hidden && !frontier[idx])
+            probs[idx] = interiorProb;
+    valid = true;
+}
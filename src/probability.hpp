@@ -0,0 +1,39 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include "cell.hpp"
+
+// Exact probability of each hidden cell being a mine, given the revealed
+// numbers, the flags (treated as mines) and the total mine count
+class ProbabilityMap {
+public:
+    // recompute from the visible board; frontier components that did not change
+    // since the previous call are served from the cache
+    void update(const std::vector<std::vector<Cell>>& grid, unsigned int totalMines);
+    void clear();
+    bool isValid() const; // false when the flags contradict the numbers
+    float at(unsigned int row, unsigned int col) const; // -1 for cells that are not hidden
+
+private:
+    struct Constraint {
+        int value;              // mines still needed around the number
+        std::vector<int> cells; // indices into Component::cells
+    };
+    // independent set of frontier cells linked by shared numbers
+    struct Component {
+        std::vector<int> cells; // flat board indices, ascending
+        std::vector<Constraint> constraints;
+        std::vector<int> key;   // cells and numbers that determine the result
+    };
+    struct ComponentResult {
+        std::vector<double> total;                   // configuration weight by mine count
+        std::vector<std::vector<double>> mineWeight; // per cell: weight with that cell mined, by mine count
+    };
+    static ComponentResult enumerate(const Component& comp);
+
+    std::map<std::vector<int>, ComponentResult> cache;
+    std::vector<float> probs;
+    unsigned int cols = 0;
+    bool valid = false;
+};
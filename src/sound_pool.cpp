@@ -0,0 +1,24 @@
+#include "sound_pool.hpp"
+
+void SoundPool::setBuffer(const sf::SoundBuffer& buffer) {
+    for (sf::Sound& voice : voices)
+        voice.setBuffer(buffer);
+}
+
+void SoundPool::play() {
+    std::size_t chosen = next;
+    for (std::size_t k = 0; k < VoiceCount; ++k) {
+        std::size_t i = (next + k) % VoiceCount;
+        if (voices[i].getStatus() == sf::SoundSource::Stopped) {
+            chosen = i;
+            break;
+        }
+    }
+    voices[chosen].play(); // restarts from the beginning if it was busy
+    next = (chosen + 1) % VoiceCount;
+}
+
+void SoundPool::stop() {
+    for (sf::Sound& voice : voices)
+        voice.stop();
+}
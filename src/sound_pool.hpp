@@ -0,0 +1,21 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <array>
+#include <cstddef>
+
+// Fixed set of voices bound to one preloaded clip, so rapid repeats overlap
+// instead of restarting each other. Playing allocates nothing and reads no files.
+class SoundPool {
+public:
+    static const std::size_t VoiceCount = 16;
+
+    void setBuffer(const sf::SoundBuffer& buffer); // bind every voice, once at startup
+    // start the clip on an idle voice; when all are busy, restart the next one in rotation
+    void play();
+    void stop();
+
+private:
+    std::array<sf::Sound, VoiceCount> voices;
+    std::size_t next = 0; // rotation point, just after the last voice started
+};
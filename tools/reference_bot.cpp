@@ -0,0 +1,204 @@
+// Reference solver for the --bot protocol, used to benchmark the engine.
+// Starts "<engine> --bot" on a pair of pipes (POSIX), plays a number of seeded
+// games with simple flag/chord deductions and random guesses, and prints the
+// win rate and throughput.
+//
+//   g++ -std=c++17 -O2 tools/reference_bot.cpp -o reference_bot
+//   ./reference_bot ./main.exe [games] [rows cols mines]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const int Flagged = 9, Hidden = 10, Mine = 11;
+
+struct Engine {
+    FILE* in = nullptr;  // commands to the engine
+    FILE* out = nullptr; // replies from the engine
+    pid_t pid = -1;
+};
+
+bool startEngine(const char* path, Engine& engine) {
+    int toEngine[2], fromEngine[2];
+    if (pipe(toEngine) != 0 || pipe(fromEngine) != 0) return false;
+    engine.pid = fork();
+    if (engine.pid < 0) return false;
+    if (engine.pid == 0) {
+        dup2(toEngine[0], STDIN_FILENO);
+        dup2(fromEngine[1], STDOUT_FILENO);
+        close(toEngine[1]);
+        close(fromEngine[0]);
+        execl(path, path, "--bot", static_cast<char*>(nullptr));
+        std::perror("exec");
+        _exit(127);
+    }
+    close(toEngine[0]);
+    close(fromEngine[1]);
+    engine.in = fdopen(toEngine[1], "w");
+    engine.out = fdopen(fromEngine[0], "r");
+    return engine.in && engine.out;
+}
+
+class Player {
+public:
+    Player(Engine& engine, unsigned int rows, unsigned int cols, unsigned int mines)
+        : engine(engine), rows(rows), cols(cols), mines(mines) {}
+
+    // play one game to the end; true on a win
+    bool play(unsigned int seed) {
+        view.assign(rows * cols, Hidden);
+        rng.seed(seed);
+        std::fprintf(engine.in, "N %u %u %u %u\n", seed, rows, cols, mines);
+        if (exchange() != 'P') return false;
+        batch = "R " + std::to_string(rows / 2) + " " + std::to_string(cols / 2);
+        actions++;
+        for (;;) {
+            std::fprintf(engine.in, "%s\n", batch.c_str());
+            char status = exchange();
+            if (status != 'P') return status == 'W';
+            planMoves();
+        }
+    }
+
+    unsigned long actions = 0;
+    unsigned long batches = 0;
+
+private:
+    // flush the pending request, read the reply and apply the changed cells
+    char exchange() {
+        std::fflush(engine.in);
+        batches++;
+        if (getline(&line, &capacity, engine.out) <= 0) {
+            std::fprintf(stderr, "engine closed the pipe\n");
+            std::exit(1);
+        }
+        if (line[0] == 'E') {
+            std::fprintf(stderr, "engine error: %s", line);
+            std::exit(1);
+        }
+        char* p = line + 1;
+        unsigned long count = std::strtoul(p, &p, 10);
+        for (unsigned long k = 0; k < count; ++k) {
+            unsigned long r = std::strtoul(p, &p, 10);
+            unsigned long c = std::strtoul(p, &p, 10);
+            view[r * cols + c] = static_cast<int>(std::strtoul(p, &p, 10));
+        }
+        return line[0];
+    }
+
+    void addMove(char kind, unsigned int r, unsigned int c) {
+        if (!batch.empty()) batch += ' ';
+        batch += kind;
+        batch += ' ';
+        batch += std::to_string(r);
+        batch += ' ';
+        batch += std::to_string(c);
+        actions++;
+    }
+
+    // hidden and flagged neighbors of a cell
+    void countAround(unsigned int r, unsigned int c, int& hidden, int& flags) const {
+        hidden = flags = 0;
+        for (int dr = -1; dr <= 1; ++dr)
+            for (int dc = -1; dc <= 1; ++dc) {
+                int nr = static_cast<int>(r) + dr, nc = static_cast<int>(c) + dc;
+                if ((dr == 0 && dc == 0) || nr < 0 || nc < 0 || nr >= static_cast<int>(rows) || nc >= static_cast<int>(cols))
+                    continue;
+                int v = view[nr * cols + nc];
+                if (v == Hidden) hidden++;
+                else if (v == Flagged) flags++;
+            }
+    }
+
+    // one batch: flag every forced mine, then chord every satisfied number;
+    // guess a random hidden cell when nothing is forced
+    void planMoves() {
+        batch.clear();
+        for (unsigned int r = 0; r < rows; ++r)
+            for (unsigned int c = 0; c < cols; ++c) {
+                int v = view[r * cols + c];
+                if (v < 1 || v > 8) continue;
+                int hidden, flags;
+                countAround(r, c, hidden, flags);
+                if (hidden == 0 || hidden + flags != v) continue;
+                for (int dr = -1; dr <= 1; ++dr)
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        int nr = static_cast<int>(r) + dr, nc = static_cast<int>(c) + dc;
+                        if (nr < 0 || nc < 0 || nr >= static_cast<int>(rows) || nc >= static_cast<int>(cols)) continue;
+                        int& n = view[nr * cols + nc];
+                        if (n == Hidden) {
+                            n = Flagged;
+                            addMove('F', nr, nc);
+                        }
+                    }
+            }
+        for (unsigned int r = 0; r < rows; ++r)
+            for (unsigned int c = 0; c < cols; ++c) {
+                int v = view[r * cols + c];
+                if (v < 1 || v > 8) continue;
+                int hidden, flags;
+                countAround(r, c, hidden, flags);
+                if (hidden > 0 && flags == v) addMove('C', r, c);
+            }
+        if (!batch.empty()) return;
+        std::vector<unsigned int>& hidden = scratch;
+        hidden.clear();
+        for (unsigned int idx = 0; idx < rows * cols; ++idx)
+            if (view[idx] == Hidden) hidden.push_back(idx);
+        unsigned int pick = hidden[rng() % hidden.size()];
+        addMove('R', pick / cols, pick % cols);
+    }
+
+    Engine& engine;
+    unsigned int rows, cols, mines;
+    std::vector<int> view;
+    std::vector<unsigned int> scratch;
+    std::string batch;
+    std::mt19937 rng;
+    char* line = nullptr;
+    size_t capacity = 0;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <engine> [games] [rows cols mines]\n", argv[0]);
+        return 1;
+    }
+    unsigned int games = argc > 2 ? static_cast<unsigned int>(std::atoi(argv[2])) : 1000;
+    unsigned int rows = 16, cols = 30, mines = 99; // expert board
+    if (argc > 5) {
+        rows = static_cast<unsigned int>(std::atoi(argv[3]));
+        cols = static_cast<unsigned int>(std::atoi(argv[4]));
+        mines = static_cast<unsigned int>(std::atoi(argv[5]));
+    }
+    Engine engine;
+    if (!startEngine(argv[1], engine)) {
+        std::perror("failed to start engine");
+        return 1;
+    }
+    Player player(engine, rows, cols, mines);
+    unsigned int wins = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int seed = 1; seed <= games; ++seed)
+        if (player.play(seed)) wins++;
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(engine.in, "Q\n");
+    std::fclose(engine.in);
+    waitpid(engine.pid, nullptr, 0);
+
+    std::printf("%u games on %ux%u with %u mines: %u won (%.1f%%)\n", games, rows, cols, mines, wins,
+                games > 0 ? 100.0 * wins / games : 0.0);
+    std::printf("%lu actions in %lu batches, %.3f s: %.0f actions/s, %.0f batches/s\n", player.actions, player.batches,
+                secs, player.actions / secs, player.batches / secs);
+    return 0;
+}